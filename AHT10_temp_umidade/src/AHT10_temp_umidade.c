@@ -1,7 +1,8 @@
 /* -------------------------------------------------------------------------------------------------------------------------------------
 / Projeto: Sensor AHT10 com OLED SSD1306
 / Descrição: Este código lê a temperatura e umidade do sensor AHT10 e exibe os dados em um display OLED SSD1306.
-/ Bibliotecas: aht10, ssd1306
+/ A leitura do sensor (com sua espera de 80 ms) roda no core1; o core0 só cuida da tela.
+/ Bibliotecas: aht10, ssd1306, acq
 / Autor: Felipe Teles do Nascimento
 / Data de Criação: 12/09/2025
 /----------------------------------------------------------------------------------------------------------------------------------------
@@ -11,6 +12,9 @@
 #include "hardware/i2c.h"
 #include "aht10.h"
 #include "ssd1306.h"
+#include "ssd1306_frame.h"
+#include "acq_core1.h"
+#include "tela.h"
 
 // I2C usado: I2C0 com SDA=GPIO4, SCL=GPIO5
 #define I2C_PORT0 i2c0
@@ -26,6 +30,28 @@ int i2c_write(uint8_t addr, const uint8_t *data, uint16_t len);
 int i2c_read(uint8_t addr, uint8_t *data, uint16_t len);
 void delay_ms(uint32_t ms);
 
+// Display OLED: enviado pelo agendador de quadros, no máximo a cada 100 ms
+#define OLED_FRAME_MS 100
+static ssd1306_t oled;
+static ssd1306_frame_t quadro;
+
+// Aquisição no core1: o AHT10 é lido a cada AHT10_PERIOD_MS e o core0 pega a
+// última leitura publicada
+#define AHT10_PERIOD_MS 1000
+static acq_t acq;
+static acq_load_t carga_core0;
+
+typedef struct {
+    float temp;
+    float hum;
+} leitura_aht10_t;
+
+// Executada no core1
+static bool ler_aht10(void *ctx, void *data) {
+    leitura_aht10_t *l = (leitura_aht10_t *)data;
+    return AHT10_ReadTemperatureHumidity((AHT10_Handle *)ctx, &l->temp, &l->hum);
+}
+
 int main() {
     stdio_init_all();
 
@@ -43,11 +69,11 @@ int main() {
     gpio_pull_up(I2C_SDA1);
     gpio_pull_up(I2C_SCL1);
 
-    ssd1306_init(I2C_PORT1);
-    ssd1306_clear();
-    ssd1306_draw_string(32, 0, "Embarcatech");
-    ssd1306_draw_string(20, 10, "Inicializando...");
-    ssd1306_show();
+    ssd1306_init(&oled, I2C_PORT1, SSD1306_I2C_ADDR);
+    ssd1306_clear(&oled);
+    ssd1306_draw_string(&oled, 32, 0, "Embarcatech");
+    ssd1306_draw_string(&oled, 20, 10, "Inicializando...");
+    ssd1306_show(&oled);
 
     // Define estrutura do sensor
     AHT10_Handle aht10 = {
@@ -61,70 +87,84 @@ int main() {
     printf("Inicializando AHT10...\n");
     if (!AHT10_Init(&aht10)) {
         printf("Falha na inicialização do sensor!\n");
-        ssd1306_clear();
-        ssd1306_draw_string(32, 0, "Embarcatech");
-        ssd1306_draw_string(23, 30, "Falha no AHT10");
-        ssd1306_show();
+        ssd1306_clear(&oled);
+        ssd1306_draw_string(&oled, 32, 0, "Embarcatech");
+        ssd1306_draw_string(&oled, 23, 30, "Falha no AHT10");
+        ssd1306_show(&oled);
         while (1) sleep_ms(1000);
     }
 
+    // A partir daqui o I2C0 é do core1
+    acq_init(&acq);
+    int fonte_aht10 = acq_add_source(&acq, ler_aht10, &aht10, sizeof(leitura_aht10_t), AHT10_PERIOD_MS);
+    acq_start(&acq);
+
+    // A primeira leitura só sai depois da conversão do sensor (~80 ms): até lá
+    // temp/hum não valem e a tela mostra "--", sem escolher tela nem alertar
+    float temp = 0, hum = 0;
+    bool tem_leitura = false;
+    tela_t tela = TELA_NORMAL;
+    ssd1306_frame_start(&quadro, &oled, OLED_FRAME_MS);
+    ssd1306_frame_begin(&quadro);
+    tela_montar(&oled, tela);
+    tela_sem_leitura(&oled);
+    ssd1306_frame_end(&quadro);
+
+    uint32_t versao = 0;
     while (1) {
-        float temp, hum;
-        if (AHT10_ReadTemperatureHumidity(&aht10, &temp, &hum)) {
+        acq_load_begin(&carga_core0, time_us_32());
+
+        // Leitura sem trava: nunca espera o sensor
+        leitura_aht10_t l;
+        uint32_t idade_us = 0;
+        if (acq_read(&acq, fonte_aht10, &l, &idade_us)) {
+            temp = l.temp;
+            hum = l.hum;
+            tem_leitura = true;
+        }
+        uint32_t v = acq_version(&acq, fonte_aht10);
+        if (v != versao) {
+            versao = v;
             printf("Temperatura: %.2f °C | Umidade: %.2f %%\n", temp, hum);
         } else {
-            printf("Falha na leitura dos dados!\n");
+            printf("Sem leitura nova do AHT10\n");
         }
-            while(hum > 70){
-                ssd1306_clear();
-                ssd1306_draw_string(32, 0, "Embarcatech");
-                ssd1306_draw_string(30, 10, "AHT10 Sensor");
-                ssd1306_draw_string(0, 20, "Umidade");
-                char hum_str[16];
-                snprintf(hum_str, sizeof(hum_str), "%.2f %%", hum);
-                ssd1306_draw_string(85, 20, hum_str);
-                ssd1306_draw_string(22,40, "Acima de 70 %");
-                ssd1306_draw_string(40,50, "ATENCAO");
-                ssd1306_show();
-                sleep_ms(500);
-                ssd1306_draw_string(40,50, "       ");
-                ssd1306_show();
-                sleep_ms(500);
-                AHT10_ReadTemperatureHumidity(&aht10, &temp, &hum);
-            }
 
-        while(temp < 20){
-                ssd1306_clear();
-                ssd1306_draw_string(32, 0, "Embarcatech");
-                ssd1306_draw_string(30, 10, "AHT10 Sensor");
-                ssd1306_draw_string(0, 20, "Temperatura");
-                char hum_str[16];
-                snprintf(hum_str, sizeof(hum_str), "%.2f C", temp);
-                ssd1306_draw_string(85, 20, hum_str);
-                ssd1306_draw_string(20,40, "Abaixo de 20 C");
-                ssd1306_draw_string(40,50, "ATENCAO");
-                ssd1306_show();
-                sleep_ms(500);
-                ssd1306_draw_string(40,50, "       ");
-                ssd1306_show();
-                sleep_ms(500);
-                AHT10_ReadTemperatureHumidity(&aht10, &temp, &hum);
+        ssd1306_frame_begin(&quadro);
+        if (tem_leitura) {
+            tela_t nova = tela_escolher(temp, hum);
+            if (nova != tela) {
+                tela = nova;
+                tela_montar(&oled, tela);
             }
-
-        ssd1306_clear();
-        ssd1306_draw_string(32, 0, "Embarcatech");
-        ssd1306_draw_string(30, 10, "AHT10 Sensor");
-        ssd1306_draw_string(0, 30, "Temperatura");
-        char temp_str[16];
-        snprintf(temp_str, sizeof(temp_str), "%.2f C", temp);
-        ssd1306_draw_string(85, 30, temp_str);
-        ssd1306_draw_string(0, 50, "Umidade");
-        char hum_str[16];
-        snprintf(hum_str, sizeof(hum_str), "%.2f %%", hum);
-        ssd1306_draw_string(85, 50, hum_str);
-        ssd1306_show();
-
-        sleep_ms(1000);
+            tela_atualizar(&oled, tela, temp, hum, to_ms_since_boot(get_absolute_time()));
+        }
+        ssd1306_frame_end(&quadro);
+
+        ssd1306_frame_stats_t fst;
+        ssd1306_frame_get_stats(&quadro, &fst);
+        printf("OLED: %lu quadros, %lu sem mudanca, pior envio %lu us\n",
+               (unsigned long)fst.pushed, (unsigned long)fst.skipped, (unsigned long)fst.worst_flush_us);
+
+        acq_source_stats_t ast;
+        acq_get_stats(&acq, fonte_aht10, &ast);
+        printf("Cores: core0 %u.%u%% core1 %u.%u%% | AHT10: idade %lu ms, %lu leituras, %lu falhas,"
+               " leitura %lu us\n",
+               carga_core0.permille / 10, carga_core0.permille % 10,
+               acq_core1_load(&acq) / 10, acq_core1_load(&acq) % 10,
+               (unsigned long)(idade_us / 1000), (unsigned long)ast.reads,
+               (unsigned long)ast.errors, (unsigned long)ast.last_read_us);
+        acq_load_end(&carga_core0, time_us_32());
+
+        // Nova leitura a cada 1 s. No alerta o "ATENCAO" pisca a cada 500 ms:
+        // só a linha dele é reenviada
+        sleep_ms(500);
+        acq_load_begin(&carga_core0, time_us_32());
+        ssd1306_frame_begin(&quadro);
+        tela_piscar(&oled, to_ms_since_boot(get_absolute_time()));
+        ssd1306_frame_end(&quadro);
+        acq_load_end(&carga_core0, time_us_32());
+        sleep_ms(500);
     }
 }
 
@@ -140,7 +180,7 @@ int i2c_read(uint8_t addr, uint8_t *data, uint16_t len) {
     return result < 0 ? -1 : 0;
 }
 
-// Função para delay
+// Função para delay (chamada no core1 durante a aquisição)
 void delay_ms(uint32_t ms) {
     sleep_ms(ms);
 }
@@ -0,0 +1,83 @@
+#include "tela.h"
+#include "ssd1306_widget.h"
+
+// Widgets: o texto fixo é desenhado uma vez por tela e os números só são
+// convertidos e redesenhados quando os dígitos exibidos mudam
+static ssd1306_label_t lbl_titulo = SSD1306_LABEL(32, 0, "Embarcatech");
+static ssd1306_label_t lbl_sensor = SSD1306_LABEL(30, 10, "AHT10 Sensor");
+static ssd1306_label_t lbl_temp = SSD1306_LABEL(0, 30, "Temperatura");
+static ssd1306_label_t lbl_umid = SSD1306_LABEL(0, 50, "Umidade");
+static ssd1306_label_t lbl_aviso = SSD1306_LABEL(22, 40, "");
+static ssd1306_number_t num_temp = SSD1306_NUMBER(79, 30, 6, 2, " C");
+static ssd1306_number_t num_umid = SSD1306_NUMBER(79, 50, 6, 2, " %");
+// Nos alertas só a linha "ATENCAO" pisca: cada troca suja 42x8 pixels
+#define PISCA_MS 500
+static ssd1306_blink_t pisca_atencao = SSD1306_BLINK(40, 50, "ATENCAO", PISCA_MS);
+
+tela_t tela_escolher(float temp, float hum) {
+    return (hum > 70) ? TELA_UMIDADE_ALTA : (temp < 20) ? TELA_TEMP_BAIXA : TELA_NORMAL;
+}
+
+void tela_montar(ssd1306_t *oled, tela_t tela) {
+    ssd1306_clear(oled);
+    ssd1306_label_reset(&lbl_titulo);
+    ssd1306_label_reset(&lbl_sensor);
+    ssd1306_label_reset(&lbl_temp);
+    ssd1306_label_reset(&lbl_umid);
+    ssd1306_label_reset(&lbl_aviso);
+    ssd1306_number_reset(&num_temp);
+    ssd1306_number_reset(&num_umid);
+    ssd1306_blink_reset(&pisca_atencao);
+
+    switch (tela) {
+    case TELA_NORMAL:
+        lbl_temp.y = num_temp.y = 30;
+        lbl_umid.y = num_umid.y = 50;
+        break;
+    case TELA_UMIDADE_ALTA:
+        lbl_umid.y = num_umid.y = 20;
+        lbl_aviso.x = 22;
+        lbl_aviso.text = "Acima de 70 %";
+        break;
+    case TELA_TEMP_BAIXA:
+        lbl_temp.y = num_temp.y = 20;
+        lbl_aviso.x = 20;
+        lbl_aviso.text = "Abaixo de 20 C";
+        break;
+    }
+
+    ssd1306_label_draw(oled, &lbl_titulo);
+    ssd1306_label_draw(oled, &lbl_sensor);
+}
+
+// "--" alinhado à direita na área do número
+static void numero_vazio(ssd1306_t *oled, const ssd1306_number_t *num) {
+    ssd1306_draw_string(oled, num->x + (num->width - 2) * 6, num->y, "--");
+}
+
+void tela_sem_leitura(ssd1306_t *oled) {
+    ssd1306_label_draw(oled, &lbl_temp);
+    ssd1306_label_draw(oled, &lbl_umid);
+    numero_vazio(oled, &num_temp);
+    numero_vazio(oled, &num_umid);
+}
+
+void tela_atualizar(ssd1306_t *oled, tela_t tela, float temp, float hum, uint32_t agora_ms) {
+    if (tela != TELA_UMIDADE_ALTA) {
+        ssd1306_label_draw(oled, &lbl_temp);
+        ssd1306_number_set(oled, &num_temp, temp);
+    }
+    if (tela != TELA_TEMP_BAIXA) {
+        ssd1306_label_draw(oled, &lbl_umid);
+        ssd1306_number_set(oled, &num_umid, hum);
+    }
+    if (tela != TELA_NORMAL) {
+        ssd1306_label_draw(oled, &lbl_aviso);
+        ssd1306_blink_set_active(oled, &pisca_atencao, true, agora_ms);
+    }
+    tela_piscar(oled, agora_ms);
+}
+
+void tela_piscar(ssd1306_t *oled, uint32_t agora_ms) {
+    ssd1306_blink_update(oled, &pisca_atencao, agora_ms);
+}
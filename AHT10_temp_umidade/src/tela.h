@@ -0,0 +1,31 @@
+#ifndef TELA_H
+#define TELA_H
+
+#include "ssd1306.h"
+
+// Telas do OLED. Só desenham no buffer; o envio fica com quem chama
+// (agendador de quadros no firmware, emulador nos testes de host)
+
+typedef enum {
+    TELA_NORMAL,
+    TELA_UMIDADE_ALTA,
+    TELA_TEMP_BAIXA
+} tela_t;
+
+// Tela adequada à leitura (alertas de umidade alta e temperatura baixa)
+tela_t tela_escolher(float temp, float hum);
+
+// Limpa o display e posiciona os widgets da tela escolhida
+void tela_montar(ssd1306_t *oled, tela_t tela);
+
+// Tela normal antes da primeira leitura: rótulos com "--" no lugar dos números
+// (tela_atualizar desenha os números por cima)
+void tela_sem_leitura(ssd1306_t *oled);
+
+// Atualiza só os campos que mudaram; nos alertas liga o "ATENCAO" piscante
+void tela_atualizar(ssd1306_t *oled, tela_t tela, float temp, float hum, uint32_t agora_ms);
+
+// Avança o pisca do alerta (redesenha só a linha do "ATENCAO" quando alterna)
+void tela_piscar(ssd1306_t *oled, uint32_t agora_ms);
+
+#endif
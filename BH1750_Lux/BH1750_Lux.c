@@ -3,6 +3,7 @@
 #include "hardware/i2c.h"
 #include "bh1750.h"
 #include "servo_velocity.h"
+#include "acq_core1.h"
 
 // #define ANGLE_ALERT_THRESHOLD 60.0f // Ângulo limite para alerta
 #define SERVO_MIN_ANGLE 0
@@ -16,6 +17,35 @@
 
 // ==== Configuração Servo ====
 #define SERVO_PIN 2
+#define SERVO_FULL_SPEED_DPS 250.0f   // graus/s com o comando máximo
+#define SERVO_VEL_MAX   180.0f        // graus/s
+#define SERVO_ACCEL_MAX 720.0f        // graus/s²
+#define SERVO_JERK_MAX  3600.0f       // graus/s³ (0: perfil trapezoidal)
+
+#define SENSOR_PERIOD_MS 1000
+
+// Aquisição no core1: o i2c0 é dele, inclusive a inicialização do BH1750 com a
+// espera de 180 ms da primeira conversão; o core0 só pega a última leitura
+static acq_t acq;
+static acq_load_t carga_core0;
+
+typedef struct {
+    i2c_inst_t *i2c;
+    bool iniciado;
+} sensor_bh1750_t;
+
+// Executada no core1
+static bool ler_bh1750(void *ctx, void *data) {
+    sensor_bh1750_t *sensor = (sensor_bh1750_t *)ctx;
+    if (!sensor->iniciado) {
+        bh1750_init(sensor->i2c);
+        sensor->iniciado = true;
+    }
+    float lux = bh1750_read_lux(sensor->i2c);
+    if (lux < 0) return false;
+    *(float *)data = lux;
+    return true;
+}
 
 int main() {
     stdio_init_all();
@@ -27,40 +57,59 @@ int main() {
     gpio_pull_up(SDA_SENSOR);
     gpio_pull_up(SCL_SENSOR);
 
-    bh1750_init(I2C_PORT_SENSOR);
-    sleep_ms(200); // tempo para estabilizar
+    // A partir daqui o I2C0 é do core1
+    static sensor_bh1750_t bh1750 = { .i2c = I2C_PORT_SENSOR };
+    acq_init(&acq);
+    int fonte_lux = acq_add_source(&acq, ler_bh1750, &bh1750, sizeof(float), SENSOR_PERIOD_MS);
+    acq_start(&acq);
 
-    servo_velocity_t servo;
-    servo_init(&servo, 2, 0.02f);  // GPIO2, ganho Kp=0.02
+    static servo_velocity_t servo;
+    servo_init(&servo, SERVO_PIN, 0.02f);  // ganho Kp=0.02 (só sem perfil)
 
-    uint32_t last_sensor_time = 0;
-    uint32_t last_display_time = 0;
+    // O servo passa a ser movido pelo perfil a 50 Hz exatos, num timer: a
+    // leitura do sensor não altera mais o período de atualização
+    const motion_limits_t limites = {
+        .vel_max = SERVO_VEL_MAX,
+        .accel_max = SERVO_ACCEL_MAX,
+        .jerk_max = SERVO_JERK_MAX
+    };
+    servo_profile_start(&servo, &limites, SERVO_FULL_SPEED_DPS);
+
+    absolute_time_t next_read = get_absolute_time();
 
     while (true) {
-        // Atualiza servo a cada ~20ms
-        servo_update(&servo);
-        sleep_ms(20);
-
-        uint32_t now = to_ms_since_boot(get_absolute_time());
-
-        // ---- Leitura do sensor (a cada 1s) ----
-        if (now - last_sensor_time >= 1000) {
-            last_sensor_time = now;
-            float lux = bh1750_read_lux(I2C_PORT_SENSOR);
-            printf("Luminosidade: %.2f lux\n", lux);
-
-            // ---- Calcular ângulo proporcional ----
-            float angle;
-            if (lux <= 0) {
-                angle = 0;
-            } else if (lux >= 100) {
-                angle = 180;
-            } else {
-                angle = (lux / 1000.0f) * 180.0f;
-            }
-
-            servo_set_target_angle(&servo, angle);
-            printf("Ângulo alvo do servo: %.2f°\n", angle);
+        // ---- Última leitura do sensor (a cada 1s), sem esperar o barramento ----
+        sleep_until(next_read);
+        next_read = delayed_by_ms(next_read, SENSOR_PERIOD_MS);
+        acq_load_begin(&carga_core0, time_us_32());
+
+        float lux;
+        uint32_t idade_us;
+        if (!acq_read(&acq, fonte_lux, &lux, &idade_us)) {
+            acq_load_end(&carga_core0, time_us_32());
+            continue;   // primeira conversão ainda em andamento
         }
+        acq_source_stats_t ast;
+        acq_get_stats(&acq, fonte_lux, &ast);
+        printf("Luminosidade: %.2f lux (idade %lu ms) | core0 %u.%u%% core1 %u.%u%% | %lu leituras,"
+               " %lu falhas, pior leitura %lu us\n",
+               lux, (unsigned long)(idade_us / 1000),
+               carga_core0.permille / 10, carga_core0.permille % 10,
+               acq_core1_load(&acq) / 10, acq_core1_load(&acq) % 10,
+               (unsigned long)ast.reads, (unsigned long)ast.errors, (unsigned long)ast.worst_read_us);
+
+        // ---- Calcular ângulo proporcional ----
+        float angle;
+        if (lux <= 0) {
+            angle = 0;
+        } else if (lux >= 100) {
+            angle = 180;
+        } else {
+            angle = (lux / 1000.0f) * 180.0f;
+        }
+
+        servo_set_target_angle(&servo, angle);
+        printf("Ângulo alvo do servo: %.2f° (estimado agora: %.2f°)\n", angle, servo.current_angle);
+        acq_load_end(&carga_core0, time_us_32());
     }
 }
\ No newline at end of file
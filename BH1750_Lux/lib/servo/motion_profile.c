@@ -0,0 +1,122 @@
+#include "motion_profile.h"
+#include <math.h>
+
+// Abaixo disso (graus, graus/s) o perfil encosta no alvo e para
+#define SETTLE_POS 0.05f
+#define SETTLE_VEL 1.0f
+
+void motion_profile_init(motion_profile_t *mp, const motion_limits_t *lim, float dt_s, float pos) {
+    mp->lim = *lim;
+    mp->dt = dt_s;
+    mp->target = pos;
+    mp->pos = pos;
+    mp->vel = 0;
+    mp->accel = 0;
+    mp->settled = true;
+}
+
+void motion_profile_set_target(motion_profile_t *mp, float target) {
+    if (target == mp->target) return;
+    mp->target = target;
+    mp->settled = false;
+}
+
+// Deslocamento com jerk constante j durante t, a partir de (v, a)
+static float travel(float *v, float *a, float j, float t) {
+    float d = *v * t + *a * t * t * 0.5f + j * t * t * t / 6.0f;
+    *v += *a * t + j * t * t * 0.5f;
+    *a += j * t;
+    return d;
+}
+
+// Distância até parar (v = 0 e a = 0) freando o mais rápido que os limites permitem.
+// Positiva no sentido de v
+static float stop_distance(const motion_limits_t *lim, float v, float a) {
+    if (v < 0) return -stop_distance(lim, -v, -a);
+
+    float amax = lim->accel_max;
+    float jerk = lim->jerk_max;
+    if (jerk <= 0) return v * v / (2.0f * amax);
+
+    // Aceleração negativa já forte demais: basta zerá-la
+    if (a < 0 && a * a > 2.0f * jerk * v) return travel(&v, &a, jerk, -a / jerk);
+
+    // Desce a aceleração até a_min, mantém, e volta a zero chegando em v = 0
+    float a_min = -sqrtf((a * a + 2.0f * jerk * v) * 0.5f);
+    float hold = 0;
+    if (a_min < -amax) {
+        a_min = -amax;
+        hold = (v + (a * a - 2.0f * amax * amax) / (2.0f * jerk)) / amax;
+        if (hold < 0) hold = 0;
+    }
+    float d = travel(&v, &a, a > a_min ? -jerk : jerk, fabsf(a - a_min) / jerk);
+    d += travel(&v, &a, 0, hold);
+    d += travel(&v, &a, jerk, -a / jerk);
+    return d;
+}
+
+// A aceleração accel no próximo período ainda permite parar no alvo (a dist à
+// frente) sem passar de vel_max?
+static bool feasible(const motion_profile_t *mp, float v, float dist, float accel) {
+    const motion_limits_t *lim = &mp->lim;
+    float v1 = v + accel * mp->dt;
+    if (v1 > lim->vel_max) return false;
+    // Com jerk limitado, a aceleração positiva ainda soma a*a/2J até zerar
+    if (lim->jerk_max > 0 && accel > 0 && v1 + accel * accel / (2.0f * lim->jerk_max) > lim->vel_max) {
+        return false;
+    }
+    return dist - v1 * mp->dt >= stop_distance(lim, v1, accel);
+}
+
+float motion_profile_step(motion_profile_t *mp) {
+    if (mp->settled) return 0;
+
+    const motion_limits_t *lim = &mp->lim;
+    float dt = mp->dt;
+    float err = mp->target - mp->pos;
+    float dir = err >= 0 ? 1.0f : -1.0f;
+
+    if (fabsf(err) < SETTLE_POS && fabsf(mp->vel) < SETTLE_VEL) {
+        mp->pos = mp->target;
+        mp->vel = 0;
+        mp->accel = 0;
+        mp->settled = true;
+        return 0;
+    }
+
+    // Trabalha no sentido do alvo: dist >= 0, v e a positivos aproximam
+    float dist = fabsf(err);
+    float v = mp->vel * dir;
+    float a = mp->accel * dir;
+
+    // Faixa de acelerações alcançáveis neste período
+    float lo = -lim->accel_max, hi = lim->accel_max;
+    if (lim->jerk_max > 0) {
+        float da = lim->jerk_max * dt;
+        if (a - da > lo) lo = a - da;
+        if (a + da < hi) hi = a + da;
+    }
+
+    // Maior aceleração rumo ao alvo que ainda permite frear a tempo (busca binária);
+    // se nem a menor permite, freia o máximo possível
+    float accel = lo;
+    if (feasible(mp, v, dist, hi)) {
+        accel = hi;
+    } else if (feasible(mp, v, dist, lo)) {
+        float ok = lo, bad = hi;
+        for (int i = 0; i < 12; i++) {
+            float mid = 0.5f * (ok + bad);
+            if (feasible(mp, v, dist, mid)) ok = mid; else bad = mid;
+        }
+        accel = ok;
+    }
+
+    v += accel * dt;
+    if (v > lim->vel_max) v = lim->vel_max;
+    if (v < -lim->vel_max) v = -lim->vel_max;
+
+    mp->accel = accel * dir;
+    mp->vel = v * dir;
+    mp->pos += mp->vel * dt;
+    return mp->vel;
+}
@@ -0,0 +1,32 @@
+#ifndef MOTION_PROFILE_H
+#define MOTION_PROFILE_H
+
+#include <stdbool.h>
+
+// Perfil de movimento com limites de velocidade, aceleração e jerk, calculado
+// passo a passo num período fixo (sem dependência de hardware). Com jerk_max = 0
+// o perfil é trapezoidal; com jerk limitado vira curva S. Um novo alvo no meio
+// do movimento parte do estado atual (posição, velocidade e aceleração).
+
+typedef struct {
+    float vel_max;      // graus/s
+    float accel_max;    // graus/s²
+    float jerk_max;     // graus/s³ (0: sem limite, perfil trapezoidal)
+} motion_limits_t;
+
+typedef struct {
+    motion_limits_t lim;
+    float dt;           // período do passo (s)
+    float target;
+    float pos;
+    float vel;
+    float accel;
+    bool settled;       // parado no alvo
+} motion_profile_t;
+
+void motion_profile_init(motion_profile_t *mp, const motion_limits_t *lim, float dt_s, float pos);
+void motion_profile_set_target(motion_profile_t *mp, float target);
+// Avança um período; retorna a velocidade comandada (graus/s)
+float motion_profile_step(motion_profile_t *mp);
+
+#endif
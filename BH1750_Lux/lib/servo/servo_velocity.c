@@ -1,41 +1,73 @@
 #include "servo_velocity.h"
+#include "hardware/sync.h"
 
 #define PULSE_STOP 1500   // µs que faz o servo parar
 #define PULSE_MAX 1900    // µs velocidade máxima
 #define PULSE_MIN 1100    // µs velocidade máxima na outra direção
 #define LOOP_MS 20        // atualização 50Hz (~20ms)
+#define FULL_SPEED_DPS 250.0f  // escala do controle P: 5 graus por atualização
 
-static void servo_set_velocity(servo_velocity_t *servo, float vel) {
+// Servos com perfil ativo: um único timer avança todos e aplica os pulsos juntos
+static servo_velocity_t *profiled[SERVO_BANK_MAX];
+static uint8_t profiled_count;
+static repeating_timer_t profile_timer;
+
+// Só prepara o pulso no banco; quem chama decide quando aplicar. No PIO o pulso
+// já vale a partir da próxima janela do canal
+static void servo_stage_velocity(servo_velocity_t *servo, float vel) {
     if (vel > 1.0f) vel = 1.0f;
     if (vel < -1.0f) vel = -1.0f;
 
-    uint16_t pulse = PULSE_STOP + (uint16_t)(vel * (PULSE_MAX - PULSE_STOP));
+    float pulse = PULSE_STOP + vel * (PULSE_MAX - PULSE_STOP);
     if (pulse < PULSE_MIN) pulse = PULSE_MIN;
     if (pulse > PULSE_MAX) pulse = PULSE_MAX;
 
-    pwm_set_chan_level(servo->slice, servo->channel, pulse);
+    if (servo->pio) servo_pio_set_pulse(servo->pio, servo->ch, pulse);
+    else servo_bank_set_pulse(servo->bank, servo->ch, pulse);
 }
 
-void servo_init(servo_velocity_t *servo, uint gpio, float Kp) {
+static void servo_set_velocity(servo_velocity_t *servo, float vel) {
+    servo_stage_velocity(servo, vel);
+    if (servo->bank) servo_bank_apply(servo->bank);
+}
+
+static void servo_init_common(servo_velocity_t *servo, uint gpio, float Kp) {
     servo->gpio = gpio;
     servo->Kp = Kp;
     servo->target_angle = 0;
     servo->current_angle = 0;
+    servo->full_speed_dps = FULL_SPEED_DPS;
+    servo->profiled = false;
+    servo->bank = NULL;
+    servo->pio = NULL;
+}
+
+void servo_init(servo_velocity_t *servo, uint gpio, float Kp) {
+    servo_init_bank(servo, servo_bank_default(), gpio, Kp);
+    servo_bank_start(servo->bank);
+}
+
+void servo_init_bank(servo_velocity_t *servo, servo_bank_t *bank, uint gpio, float Kp) {
+    servo_init_common(servo, gpio, Kp);
+
+    // 50 Hz com o divisor calculado do clock do sistema; pulso inicial parado
+    servo->bank = bank;
+    servo->ch = servo_bank_add(bank, gpio);
+}
 
-    gpio_set_function(gpio, GPIO_FUNC_PWM);
-    servo->slice = pwm_gpio_to_slice_num(gpio);
-    servo->channel = pwm_gpio_to_channel(gpio);
+void servo_init_pio(servo_velocity_t *servo, servo_pio_t *pio, uint gpio, float Kp) {
+    servo_init_common(servo, gpio, Kp);
 
-    pwm_config config = pwm_get_default_config();
-    pwm_config_set_clkdiv(&config, 125.0f);   // 1 tick = 1µs
-    pwm_config_set_wrap(&config, 20000 - 1);  // 20ms = 50Hz
-    pwm_init(servo->slice, &config, true);
+    servo->pio = pio;
+    servo->ch = servo_pio_channel(pio, gpio);
+    servo_set_velocity(servo, 0);
 }
 
 void servo_set_target_angle(servo_velocity_t *servo, float angle) {
     if (angle < 0) angle = 0;
     if (angle > 180) angle = 180;
     servo->target_angle = angle;
+    if (servo->profiled) motion_profile_set_target(&servo->profile, angle);
 }
 
 void servo_update(servo_velocity_t *servo) {
@@ -48,7 +80,67 @@ void servo_update(servo_velocity_t *servo) {
     servo_set_velocity(servo, velocity);
 
     // Atualiza posição estimada
-    servo->current_angle += velocity * 5.0f;  // constante de escala
+    servo->current_angle += velocity * FULL_SPEED_DPS * LOOP_MS / 1000.0f;
     if (servo->current_angle > 180) servo->current_angle = 180;
     if (servo->current_angle < 0) servo->current_angle = 0;
 }
+
+// Tick do perfil (IRQ do timer): avança todos os servos com perfil e aplica os
+// pulsos de uma vez, no mesmo quadro do PWM. A posição estimada é a do perfil
+static bool profile_tick(repeating_timer_t *rt) {
+    (void)rt;
+    for (uint8_t i = 0; i < profiled_count; i++) {
+        servo_velocity_t *servo = profiled[i];
+        float vel_dps = motion_profile_step(&servo->profile);
+
+        servo_stage_velocity(servo, vel_dps / servo->full_speed_dps);
+        servo->current_angle = servo->profile.pos;
+    }
+    // Servos de bancos diferentes: cada banco aplica o que é seu
+    for (uint8_t i = 0; i < profiled_count; i++) {
+        servo_bank_t *bank = profiled[i]->bank;
+        if (bank && bank->dirty_mask) servo_bank_apply(bank);
+    }
+    return true;
+}
+
+bool servo_profile_start(servo_velocity_t *servo, const motion_limits_t *lim, float full_speed_dps) {
+    if (servo->profiled) return true;
+    if (profiled_count >= SERVO_BANK_MAX) return false;
+
+    motion_limits_t l = *lim;
+    // O servo não passa da velocidade do comando máximo
+    if (l.vel_max > full_speed_dps) l.vel_max = full_speed_dps;
+
+    servo->full_speed_dps = full_speed_dps;
+    motion_profile_init(&servo->profile, &l, LOOP_MS / 1000.0f, servo->current_angle);
+    motion_profile_set_target(&servo->profile, servo->target_angle);
+
+    // O primeiro servo liga o timer. Período negativo: 20 ms entre inícios de
+    // tick, sem acumular o tempo do tick
+    if (profiled_count == 0 && !add_repeating_timer_ms(-LOOP_MS, profile_tick, NULL, &profile_timer)) {
+        return false;
+    }
+    uint32_t irq = save_and_disable_interrupts();
+    profiled[profiled_count++] = servo;
+    servo->profiled = true;
+    restore_interrupts(irq);
+    return true;
+}
+
+void servo_profile_stop(servo_velocity_t *servo) {
+    if (!servo->profiled) return;
+
+    uint32_t irq = save_and_disable_interrupts();
+    for (uint8_t i = 0; i < profiled_count; i++) {
+        if (profiled[i] == servo) {
+            profiled[i] = profiled[--profiled_count];
+            break;
+        }
+    }
+    servo->profiled = false;
+    restore_interrupts(irq);
+
+    if (profiled_count == 0) cancel_repeating_timer(&profile_timer);
+    servo_set_velocity(servo, 0);
+}
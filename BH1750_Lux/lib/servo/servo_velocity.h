@@ -2,24 +2,46 @@
 #define SERVO_VELOCITY_H
 
 #include "pico/stdlib.h"
-#include "hardware/pwm.h"
+#include "servo_bank.h"
+#include "servo_pio.h"
+#include "motion_profile.h"
 
 typedef struct {
     uint gpio;        // GPIO conectado ao servo
-    uint slice;       // slice PWM
-    uint channel;     // canal PWM
+    servo_bank_t *bank;  // banco de PWM do servo (NULL se a saída for por PIO)
+    servo_pio_t *pio;    // gerador PIO do servo (NULL se a saída for por PWM)
+    int ch;           // canal no banco ou no gerador PIO
     float target_angle; // ângulo alvo estimado
     float current_angle; // posição estimada
     float Kp;         // ganho proporcional da velocidade
+
+    // Perfil de movimento (servo_profile_start): executado por um timer a 50 Hz
+    // comum a todos os servos com perfil
+    motion_profile_t profile;
+    float full_speed_dps;   // graus/s com o comando de velocidade máximo
+    volatile bool profiled;
 } servo_velocity_t;
 
-// Inicializa o servo no GPIO especificado
+// Inicializa o servo no GPIO especificado (banco padrão, já em funcionamento)
 void servo_init(servo_velocity_t *servo, uint gpio, float Kp);
+// Inicializa o servo num banco: para vários servos (pan/tilt), adicione todos e
+// chame servo_bank_start() uma vez, deixando as fatias em fase
+void servo_init_bank(servo_velocity_t *servo, servo_bank_t *bank, uint gpio, float Kp);
+// Inicializa o servo num gerador PIO já iniciado (gpio dentro dos pinos dele),
+// para quando faltam fatias de PWM. Mesma API de ângulo, controle P e perfil
+void servo_init_pio(servo_velocity_t *servo, servo_pio_t *pio, uint gpio, float Kp);
 
 // Define o ângulo alvo (0 a 180)
 void servo_set_target_angle(servo_velocity_t *servo, float angle);
 
-// Atualiza o servo (chamar dentro do loop)
+// Atualiza o servo (chamar dentro do loop) - controle P, sem perfil
 void servo_update(servo_velocity_t *servo);
 
+// Passa o servo para o perfil de movimento: um repeating_timer a 50 Hz exatos
+// (o período conta do início de cada tick) avança o perfil de todos os servos
+// com perfil e aplica os pulsos de uma vez (servo_bank_apply).
+// full_speed_dps: graus/s do servo com comando máximo. Não chame servo_update() depois.
+bool servo_profile_start(servo_velocity_t *servo, const motion_limits_t *lim, float full_speed_dps);
+void servo_profile_stop(servo_velocity_t *servo);
+
 #endif
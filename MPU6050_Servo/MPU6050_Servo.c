@@ -1,9 +1,10 @@
 /* -------------------------------------------------------------------------------------------------------------------------------------
 / Projeto: MPU6050_SERVO
 / Descrição: Este projeto utiliza um sensor de movimento MPU6050 para controlar a posição de um servo contínuo simulado, 
-/ exibindo informações em um display OLED SSD1306. O servo é calibrado automaticamente no boot se um botão for pressionado, 
-/ e o tempo de rotação é salvo na memória flash para uso futuro. A posição do servo é determinada pela inclinação do sensor: 
-/ inclinação para frente move o servo para 0 graus, inclinação para trás para 90 graus, e inclinação lateral para 180 graus. 
+/ exibindo informações em um display OLED SSD1306. O servo é calibrado no boot (giro medido pelo MPU6050 preso ao eixo) só se um 
+/ botão for pressionado (sem calibração confiável o boot apenas avisa), e o tempo de rotação é salvo na flash para uso futuro. 
+/ A posição do servo acompanha continuamente a inclinação (pitch) estimada pela fusão acelerômetro + giroscópio: 
+/ sensor nivelado leva o servo a 90 graus, e ±90 graus de pitch levam a 0/180 graus. 
 / Os valores dos ângulos são aproximados pois o servo não guarda a posição.
 / Bibliotecas: pico-sdk, extras (servo_sim, flash_storage, ssd1306, mpu6050).
 / Autor: Felipe Teles do Nascimento
@@ -16,13 +17,18 @@
 #include "servo_sim.h"
 #include "flash_storage.h"
 #include "ssd1306.h"
+#include "ssd1306_frame.h"
 #include "mpu6050_i2c.h"
+#include "imu_fusion.h"
+#include "buzzer_pwm.h"
+#include "tela.h"
 
 // ==== Pinos ====
 #define SERVO_PIN    2     // GPIO do servo contínuo (simulado)
-#define BTN_CALIB    5     // Botão de calibração (ativo em nível baixo)
-#define BUZZER1_PIN  10    // Buzzer 1
-#define BUZZER2_PIN  27    // Buzzer 2
+#define BTN_CALIB    5     // Botão de calibração no boot / troca de tela (ativo em nível baixo)
+#define BUZZER1_PIN  10    // Buzzer 1 (PWM fatia 5, canal A)
+#define BUZZER2_PIN  27    // Buzzer 2 (PWM fatia 5, canal B)
+#define MPU_INT_PIN  16    // Pino INT do MPU6050 (dado pronto / movimento)
 
 // I2C OLED (i2c1)
 #define I2C_PORT_OLED i2c1
@@ -31,6 +37,58 @@
 
 // ==== Configurações ====
 #define ALERT_THRESHOLD 90.0f   // Ângulo limite para alerta
+#define OLED_FRAME_MS   50      // Período máximo de envio do OLED (20 quadros/s)
+#define IMU_RATE_HZ     100     // Amostragem do MPU6050 com movimento
+#define IMU_IDLE_HZ     10      // Amostragem em repouso
+#define IMU_QUIET_MS    3000    // Tempo sem movimento para voltar ao repouso
+#define IMU_MOT_MG      40      // Limiar da detecção de movimento
+#define IMU_MOT_MS      5       // Duração mínima acima do limiar
+#define IMU_DLPF        3       // Filtro passa-baixa interno (~44 Hz, ~5 ms de atraso)
+#define IMU_GYRO_RANGE  1       // ±500 °/s
+#define IMU_ACCEL_RANGE 0       // ±2 g
+#define IMU_RING_SIZE   64      // Amostras guardadas entre voltas do loop (potência de 2)
+#define IMU_FUSION_MODE IMU_FUSION_MADGWICK   // ou IMU_FUSION_COMPLEMENTARY
+#define SERVO_STEP_DEG  2.0f    // Passo máximo do servo por volta do loop
+#define LOOP_ACTIVE_MS  200     // Período do loop com movimento
+#define LOOP_IDLE_MS    500     // Período do loop em repouso
+#define CALIB_RUNS      4       // Corridas da calibração (sentidos alternados)
+#define CALIB_MIN_CONF  700     // Abaixo desta confiança (‰) o boot pede recalibração
+
+// Alerta sonoro: bipes de 100 ms alternando os buzzers a cada 400 ms, tocado
+// pelo alarme do buzzer_pwm enquanto o alerta durar
+#define BEEP_HZ 2000
+static const buzzer_step_t bipe_alerta[] = {
+    {0, BEEP_HZ, 0, 100}, {0, 0, 0, 300},
+    {1, BEEP_HZ, 0, 100}, {1, 0, 0, 300},
+};
+static const buzzer_pattern_t padrao_alerta = BUZZER_PATTERN(bipe_alerta, 0);
+static buzzer_pwm_t buzzer;
+
+// Curva de velocidade do servo, medida com o giro Z do MPU6050 preso ao eixo
+static servo_lut_t curva_servo;
+
+// Display OLED
+static ssd1306_t oled;
+static ssd1306_frame_t quadro;
+
+// Velocidade média (graus/s) no eixo Z durante a janela: o MPU6050 gira com o servo
+static float medir_giro_z(void *ctx, uint32_t janela_ms) {
+    (void)ctx;
+    int64_t soma_mdps = 0;
+    uint32_t n = 0;
+    absolute_time_t fim = make_timeout_time_ms(janela_ms);
+    while (!time_reached(fim)) {
+        mpu6050_sample_t s;
+        mpu6050_scaled_t e;
+        if (mpu6050_read_sample(&s, MPU6050_GYRO)) {
+            mpu6050_scale(&s, &e);
+            soma_mdps += e.gyro_mdps[2];
+            n++;
+        }
+        sleep_ms(2);
+    }
+    return n ? (float)soma_mdps / n / 1000.0f : 0;
+}
 
 int main() {
     stdio_init_all();
@@ -41,13 +99,8 @@ int main() {
     gpio_pull_up(BTN_CALIB);
 
     // === Buzzers ===
-    gpio_init(BUZZER1_PIN);
-    gpio_set_dir(BUZZER1_PIN, GPIO_OUT);
-    gpio_put(BUZZER1_PIN, 0);
-
-    gpio_init(BUZZER2_PIN);
-    gpio_set_dir(BUZZER2_PIN, GPIO_OUT);
-    gpio_put(BUZZER2_PIN, 0);
+    static const uint buzzer_pins[] = { BUZZER1_PIN, BUZZER2_PIN };
+    buzzer_pwm_init(&buzzer, buzzer_pins, 2, NULL);
 
     // === Inicializa MPU6050 (I2C0) ===
     mpu6050_setup_i2c();
@@ -58,6 +111,9 @@ int main() {
         printf("MPU6050 nao encontrado!\n");
         while (1) sleep_ms(1000);
     }
+    mpu6050_config_t imu_cfg = { .dlpf = IMU_DLPF, .gyro_range = IMU_GYRO_RANGE,
+                                 .accel_range = IMU_ACCEL_RANGE };
+    mpu6050_configure(&imu_cfg);
 
     // === Inicializa OLED (I2C1) ===
     i2c_init(I2C_PORT_OLED, 400000);
@@ -65,106 +121,229 @@ int main() {
     gpio_set_function(SCL_OLED, GPIO_FUNC_I2C);
     gpio_pull_up(SDA_OLED);
     gpio_pull_up(SCL_OLED);
-    ssd1306_init(I2C_PORT_OLED);
+    ssd1306_init(&oled, I2C_PORT_OLED, SSD1306_I2C_ADDR);
 
     // Tela inicial
-    ssd1306_clear();
-    ssd1306_draw_string(20, 0, "Servo MPU6050");
-    ssd1306_draw_string(8, 12, "Inicializando...");
-    ssd1306_show();
+    ssd1306_clear(&oled);
+    ssd1306_draw_string(&oled, 20, 0, "Servo MPU6050");
+    ssd1306_draw_string(&oled, 8, 12, "Inicializando...");
+    ssd1306_show(&oled);
     sleep_ms(1000);
 
     // === Servo: carrega calibração ===
     uint32_t rotation_time_ms = 1000;
-    bool have_calib = flash_storage_read(&rotation_time_ms);
+    uint16_t confianca = 0;
+    bool have_calib = flash_storage_read(&rotation_time_ms, &confianca);
 
     servo_sim_t servo;
     servo_sim_init(&servo, SERVO_PIN, (float)rotation_time_ms);
 
-    if (!gpio_get(BTN_CALIB)) {
-        ssd1306_clear();
-        ssd1306_draw_string(20, 24, "Calibrando...");
-        ssd1306_show();
+    bool have_lut = flash_storage_read_lut(&curva_servo, sizeof(curva_servo));
+    bool forcar = !gpio_get(BTN_CALIB);
+
+    if (forcar) {
+        // Curva de velocidade: varre os pulsos medindo o giro (~8 s)
+        ssd1306_clear(&oled);
+        ssd1306_draw_string(&oled, 14, 24, "Medindo curva...");
+        ssd1306_show(&oled);
 
-        servo_sim_calibrate(&servo);
-        rotation_time_ms = (uint32_t)(180.0f / servo.deg_per_ms);
-        flash_storage_write(rotation_time_ms);
+        have_lut = servo_sim_identify(&servo, &curva_servo, medir_giro_z, NULL);
+        if (have_lut) flash_storage_write_lut(&curva_servo, sizeof(curva_servo));
+        for (uint8_t i = 0; i < curva_servo.count; i++) {
+            printf("%u us: %.1f graus/s\n", servo_lut_pulse_at(&curva_servo, i), curva_servo.dps[i]);
+        }
+    }
+
+    // Só recalibra com o botão: o servo nunca gira no boot sem ação do usuário.
+    // Sem calibração, ou com uma não confiável (gravada às cegas por versões
+    // antigas, ou com corridas muito diferentes entre si), só avisa
+    if (forcar) {
+        ssd1306_clear(&oled);
+        ssd1306_draw_string(&oled, 20, 24, "Calibrando...");
+        ssd1306_show(&oled);
+
+        servo_calib_t calib;
+        if (servo_sim_calibrate(&servo, medir_giro_z, NULL, CALIB_RUNS, &calib)) {
+            rotation_time_ms = (uint32_t)(calib.rotation_time_ms + 0.5f);
+            flash_storage_write(rotation_time_ms, calib.confidence_pm);
+        }
+        printf("Calibracao: %lu ms +- %.1f ms, %u corridas (%u no fim de curso), confianca %u/1000\n",
+               (unsigned long)rotation_time_ms, calib.stddev_ms, calib.runs, calib.end_stops,
+               calib.confidence_pm);
 
-        ssd1306_clear();
-        ssd1306_draw_string(8, 24, "Calibracao salva!");
-        ssd1306_show();
+        char msg[24];
+        snprintf(msg, sizeof(msg), "%lums conf %u%%", (unsigned long)rotation_time_ms, calib.confidence_pm / 10);
+        ssd1306_clear(&oled);
+        ssd1306_draw_string(&oled, 8, 16, calib.runs ? "Calibracao salva!" : "Servo nao girou!");
+        ssd1306_draw_string(&oled, 8, 32, msg);
+        ssd1306_show(&oled);
         sleep_ms(1200);
-    } else if (have_calib) {
+    } else {
+        bool confiavel = have_calib && confianca >= CALIB_MIN_CONF;
         char msg[24];
-        snprintf(msg, sizeof(msg), "Calib: %ums", rotation_time_ms);
-        ssd1306_clear();
-        ssd1306_draw_string(10, 24, msg);
-        ssd1306_show();
-        sleep_ms(800);
+        snprintf(msg, sizeof(msg), "Calib: %lums", (unsigned long)rotation_time_ms);
+        ssd1306_clear(&oled);
+        ssd1306_draw_string(&oled, 10, confiavel ? 24 : 16, have_calib ? msg : "Sem calibracao");
+        if (!confiavel) {
+            ssd1306_draw_string(&oled, 4, 32, "Botao no boot");
+            printf("Calibracao %s (confianca %u/1000): segure o botao no boot para calibrar\n",
+                   have_calib ? "nao confiavel" : "ausente", confianca);
+        }
+        ssd1306_show(&oled);
+        sleep_ms(confiavel ? 800 : 2000);
     }
-        
+    // Com a curva medida, o pulso e a posição estimada saem do modelo não linear
+    if (have_lut) servo_sim_set_lut(&servo, &curva_servo);
+
     float current_angle = 90.0f;  // posição inicial
     bool alert_active = false;
-    int frame = 0;
-    bool use_buzzer1 = true;
+    bool alert_shown = false;
+    bool grafico = false;
+    bool btn_antes = gpio_get(BTN_CALIB);
+    bool alert_sound = false;
+    bool flash_mantida = false;      // compactação já tentada neste período ocioso
+    uint32_t perdidas_flash = 0;     // amostras do MPU6050 perdidas nos apagamentos
 
     char alert_msg[32];
     snprintf(alert_msg, sizeof(alert_msg), "!!! ALERTA >%.0f !!!", ALERT_THRESHOLD);
 
+    // Tela principal: texto fixo desenhado uma única vez. A partir daqui os envios
+    // ficam com o agendador; o loop só desenha entre begin/end
+    tela_montar(&oled, grafico);
+    ssd1306_frame_start(&quadro, &oled, OLED_FRAME_MS);
+
+    // A cada dado pronto a IRQ do pino INT lê a amostra e a publica no anel; o loop
+    // (que dorme no servo, no buzzer...) consome tudo o que chegou desde a última volta.
+    // Em repouso amostra a IMU_IDLE_HZ; a interrupção de movimento sobe para IMU_RATE_HZ
+    static mpu6050_sample_t imu_buf[IMU_RING_SIZE];
+    spsc_ring_t imu_ring;
+    mpu6050_stream_t imu;
+    spsc_ring_init(&imu_ring, imu_buf, sizeof(mpu6050_sample_t), IMU_RING_SIZE);
+    mpu6050_stream_start(&imu, &imu_ring, MPU_INT_PIN, IMU_IDLE_HZ, IMU_DLPF,
+                         MPU6050_ACCEL | MPU6050_GYRO);
+    mpu6050_motion_enable(IMU_MOT_MG, IMU_MOT_MS);
+    mpu6050_adaptive_t adapt;
+    mpu6050_adaptive_init(&adapt, IMU_IDLE_HZ, IMU_RATE_HZ, IMU_QUIET_MS, time_us_32());
+
+    // Fusão em ponto fixo, atualizada a cada amostra
+    imu_fusion_t fusao;
+    imu_fusion_init(&fusao, IMU_FUSION_MODE, IMU_GYRO_RANGE);
+
+    // Loop em período fixo: o prazo é absoluto, então o tempo gasto na volta
+    // (printf, desenho, buzzer, flash) não se soma ao período. O envio do OLED
+    // (via DMA) sai no próximo tick do agendador; em repouso o loop desacelera
+    absolute_time_t proxima_volta = get_absolute_time();
+
     while (true) {
-        int16_t accel[3], gyro[3], temp_raw;
-        mpu6050_read_raw(accel, gyro, &temp_raw);
+        sleep_until(proxima_volta);
+        proxima_volta = delayed_by_ms(proxima_volta, adapt.active ? LOOP_ACTIVE_MS : LOOP_IDLE_MS);
 
-        // Escolha de ângulo: simples → aceleração no eixo X
-        float ax = accel[0] / ACCEL_SENS_2G;
-        float target_angle = (ax < -0.5f) ? 0.0f : (ax < 0.5f ? 90.0f : 180.0f);
+        if (mpu6050_adaptive_update(&adapt, &imu, time_us_32())) {
+            printf("IMU %s: repouso %llums/%lu amostras, ativo %llums/%lu amostras\n",
+                   adapt.active ? "ativo" : "repouso",
+                   (unsigned long long)(adapt.time_us[0] / 1000), (unsigned long)adapt.samples[0],
+                   (unsigned long long)(adapt.time_us[1] / 1000), (unsigned long)adapt.samples[1]);
+        }
+
+        // AX médio das amostras desde a última volta; a mais recente vai para o debug.
+        // Cada amostra também vira um ponto do histórico (no máximo um anel por volta)
+        mpu6050_sample_t amostra;
+        mpu6050_scaled_t med;
+        int32_t historico_ax[IMU_RING_SIZE];
+        int32_t soma_ax_mg = 0;
+        uint16_t n = 0;
+        while (n < IMU_RING_SIZE && spsc_ring_pop(&imu_ring, &amostra)) {
+            imu_fusion_update(&fusao, amostra.accel, amostra.gyro, amostra.timestamp_us);
+            mpu6050_scale(&amostra, &med);
+            historico_ax[n] = med.accel_mg[0];
+            soma_ax_mg += med.accel_mg[0];
+            n++;
+        }
+        if (n == 0) continue;   // nenhuma amostra nova no período: espera o próximo
+
+        // Ângulo contínuo: pitch -90..+90 graus leva o alvo de 180 a 0 graus
+        int32_t ax_mg = soma_ax_mg / n;
+        int32_t pitch = Q16_TO_INT(fusao.pitch);
+        float target_angle = (float)(90 - (pitch < -90 ? -90 : pitch > 90 ? 90 : pitch));
 
         // Movimento suave
-        if (current_angle < target_angle) current_angle += 2.0f;
-        else if (current_angle > target_angle) current_angle -= 2.0f;
+        float passo = target_angle - current_angle;
+        if (passo > SERVO_STEP_DEG) passo = SERVO_STEP_DEG;
+        else if (passo < -SERVO_STEP_DEG) passo = -SERVO_STEP_DEG;
+        current_angle += passo;
 
         // Atualiza flag do alerta
         alert_active = (current_angle > ALERT_THRESHOLD);
 
         // Debug serial
         printf(">");
-        printf("AX=%.2fg AY=%.2fg AZ=%.2fg | GX=%d GY=%d GZ=%d | Alvo=%.0f deg | Atual=%.0f deg\n",
-               accel[0]/ACCEL_SENS_2G, accel[1]/ACCEL_SENS_2G, accel[2]/ACCEL_SENS_2G,
-               gyro[0], gyro[1], gyro[2], target_angle, current_angle);
+        printf("AX=%ldmg AY=%ldmg AZ=%ldmg | GX=%ld GY=%ld GZ=%ld mdps | Alvo=%.0f deg | Atual=%.0f deg"
+               " | %u amostras, %lu perdidas, %lu na flash\n",
+               (long)med.accel_mg[0], (long)med.accel_mg[1], (long)med.accel_mg[2],
+               (long)med.gyro_mdps[0], (long)med.gyro_mdps[1], (long)med.gyro_mdps[2],
+               target_angle, current_angle,
+               n, (unsigned long)imu_ring.overruns, (unsigned long)perdidas_flash);
 
-        // Servo simulado
+        // Servo simulado: só inicia (ou redireciona) o giro; o alarme o para no alvo
         servo_sim_set_angle(&servo, current_angle);
 
         // === Display ===
-        ssd1306_clear();
-        ssd1306_draw_string(20, 0, "Servo MPU6050");
-
-        char line1[24], line2[24];
-        snprintf(line1, sizeof(line1), "AX: %.2fg", accel[0]/ACCEL_SENS_2G);
-        snprintf(line2, sizeof(line2), "Ang: %.0f/%0.f", current_angle, target_angle);
-
-        ssd1306_draw_string(6, 20, line1);
-        ssd1306_draw_string(6, 36, line2);
-
-        // Alerta piscante + beep alternado
-        if (alert_active && (frame % 2 == 0)) {
-            ssd1306_draw_string(6, 52, alert_msg);
-
-            if (use_buzzer1) {
-                gpio_put(BUZZER1_PIN, 1);
-                sleep_ms(100);
-                gpio_put(BUZZER1_PIN, 0);
-            } else {
-                gpio_put(BUZZER2_PIN, 1);
-                sleep_ms(100);
-                gpio_put(BUZZER2_PIN, 0);
-            }
-            use_buzzer1 = !use_buzzer1; // alterna buzzer
+        ssd1306_frame_begin(&quadro);
+
+        // Botão alterna entre os valores e o gráfico; o histórico segue sendo gravado
+        bool btn = gpio_get(BTN_CALIB);
+        if (btn_antes && !btn) {
+            grafico = !grafico;
+            alert_shown = false;
+            tela_montar(&oled, grafico);
         }
+        btn_antes = btn;
 
-        ssd1306_show();
-        frame++;
+        tela_historico(&oled, grafico, historico_ax, n);
+        tela_atualizar(&oled, grafico, ax_mg, servo_sim_get_angle(&servo), target_angle);
 
-        sleep_ms(200);
+        // Alerta em letreiro: texto desenhado uma vez e rolado pelo SSD1306 + beep alternado
+        if (!grafico && alert_active != alert_shown) {
+            alert_shown = alert_active;
+            tela_alerta(&oled, alert_active ? alert_msg : NULL);
+        }
+        ssd1306_frame_end(&quadro);
+
+        // Bipe alternado: só inicia/para o padrão, quem toca é o alarme
+        if (alert_active != alert_sound) {
+            alert_sound = alert_active;
+            uint32_t t0 = time_us_32();
+            if (alert_active) buzzer_play(&buzzer, &padrao_alerta);
+            else buzzer_stop(&buzzer);
+            printf("Buzzer: %s em %lu us (pior passo no alarme %lu us)\n",
+                   alert_active ? "play" : "stop", (unsigned long)(time_us_32() - t0),
+                   (unsigned long)buzzer.worst_handler_us);
+
+            // Trace dos últimos passos: intervalos entre trocas de tom feitas no alarme
+            buzzer_trace_t tr[BUZZER_TRACE_LEN];
+            uint8_t nt = buzzer_get_trace(&buzzer, tr, BUZZER_TRACE_LEN);
+            for (uint8_t i = 1; i < nt; i++) {
+                printf("  +%lu us: canal %u %u Hz (%u us no alarme)\n",
+                       (unsigned long)(tr[i].time_us - tr[i - 1].time_us),
+                       tr[i].channel, tr[i].freq_hz, tr[i].handler_us);
+            }
+        }
+
+        // Compactação da flash: no máximo uma por período ocioso (servo parado e
+        // sem alerta). O apagamento desliga as interrupções por ~50 ms: só roda
+        // sem envio do OLED em andamento, e dentro de begin/end para o agendador
+        // não iniciar outro. As amostras que o MPU6050 gerar nesse tempo se
+        // perdem (o dado pronto é sobrescrito) e são contadas pelo tempo
+        if (servo_sim_is_moving(&servo) || alert_active) {
+            flash_mantida = false;
+        } else if (!flash_mantida) {
+            ssd1306_frame_begin(&quadro);
+            if (!ssd1306_flush_busy(&oled)) {
+                uint32_t t0 = time_us_32();
+                if (flash_storage_maintain()) perdidas_flash += (time_us_32() - t0) / imu.sample_period_us;
+                flash_mantida = true;
+            }
+            ssd1306_frame_end(&quadro);
+        }
     }
 }
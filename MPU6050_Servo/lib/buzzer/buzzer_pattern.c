@@ -0,0 +1,47 @@
+#include "buzzer_pattern.h"
+
+void buzzer_seq_start(buzzer_seq_t *seq, const buzzer_pattern_t *pattern) {
+    seq->pattern = (pattern && pattern->count) ? pattern : NULL;
+    seq->index = 0;
+    seq->played = 0;
+    seq->step_ms = 0;
+}
+
+uint32_t buzzer_seq_next(buzzer_seq_t *seq, buzzer_tone_t *tone) {
+    const buzzer_pattern_t *p = seq->pattern;
+    tone->channel = 0;
+    tone->freq_hz = 0;
+    if (!p) return 0;
+
+    if (seq->index >= p->count) {
+        seq->played++;
+        if (p->repeat && seq->played >= p->repeat) {
+            seq->pattern = NULL;
+            return 0;
+        }
+        seq->index = 0;
+    }
+
+    const buzzer_step_t *st = &p->steps[seq->index];
+    uint16_t duration = st->duration_ms ? st->duration_ms : 1;
+    tone->channel = st->channel;
+
+    if (!st->freq_end_hz || st->freq_end_hz == st->freq_hz) {
+        tone->freq_hz = st->freq_hz;
+        seq->index++;
+        return duration;
+    }
+
+    // Varredura: fatias de BUZZER_SWEEP_MS com a frequência interpolada no início de cada uma
+    uint16_t chunk = duration - seq->step_ms;
+    if (chunk > BUZZER_SWEEP_MS) chunk = BUZZER_SWEEP_MS;
+    int32_t span = (int32_t)st->freq_end_hz - st->freq_hz;
+    tone->freq_hz = (uint16_t)(st->freq_hz + span * seq->step_ms / duration);
+
+    seq->step_ms += chunk;
+    if (seq->step_ms >= duration) {
+        seq->step_ms = 0;
+        seq->index++;
+    }
+    return chunk;
+}
@@ -0,0 +1,52 @@
+#ifndef BUZZER_PATTERN_H
+#define BUZZER_PATTERN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Sequenciador de padrões de buzzer, sem dependência de hardware (roda no host):
+// a cada chamada de buzzer_seq_next() devolve o tom a tocar agora e por quanto
+// tempo. Quem chama (o alarme do buzzer_pwm) aplica o tom e se reagenda.
+
+// Passo do padrão: tom num canal (buzzer) por duration_ms
+typedef struct {
+    uint8_t channel;
+    uint16_t freq_hz;       // 0: silêncio
+    uint16_t freq_end_hz;   // != 0: varredura linear de freq_hz até freq_end_hz
+    uint16_t duration_ms;
+} buzzer_step_t;
+
+typedef struct {
+    const buzzer_step_t *steps;
+    uint8_t count;
+    uint8_t repeat;         // vezes que a sequência toca; 0 = até parar
+} buzzer_pattern_t;
+
+#define BUZZER_PATTERN(steps_, repeat_) \
+    { .steps = (steps_), .count = sizeof(steps_) / sizeof((steps_)[0]), .repeat = (repeat_) }
+
+// Resolução das varreduras: a frequência muda a cada BUZZER_SWEEP_MS
+#define BUZZER_SWEEP_MS 10
+
+typedef struct {
+    uint8_t channel;
+    uint16_t freq_hz;       // 0: silêncio
+} buzzer_tone_t;
+
+typedef struct {
+    const buzzer_pattern_t *pattern;
+    uint8_t index;          // próximo passo
+    uint8_t played;         // repetições completas
+    uint16_t step_ms;       // parte já tocada do passo atual (varreduras)
+} buzzer_seq_t;
+
+void buzzer_seq_start(buzzer_seq_t *seq, const buzzer_pattern_t *pattern);
+// Tom a tocar agora e por quantos ms mantê-lo; 0 = padrão terminou (silêncio)
+uint32_t buzzer_seq_next(buzzer_seq_t *seq, buzzer_tone_t *tone);
+
+static inline bool buzzer_seq_done(const buzzer_seq_t *seq) {
+    return seq->pattern == NULL;
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include "buzzer_pwm.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+
+// Aplica o tom: silencia todos os canais e liga só o pedido
+static void apply_tone(buzzer_pwm_t *bz, const buzzer_tone_t *tone) {
+    for (uint8_t i = 0; i < bz->count; i++) pwm_set_chan_level(bz->slice[i], bz->chan[i], 0);
+    if (!tone->freq_hz || tone->channel >= bz->count) return;
+
+    // Menor divisor inteiro que mantém o wrap em 16 bits: maior resolução de frequência
+    uint32_t sys_hz = clock_get_hz(clk_sys);
+    uint32_t div = sys_hz / ((uint32_t)tone->freq_hz * 65536u) + 1;
+    if (div > 255) div = 255;
+    uint32_t wrap = sys_hz / (div * tone->freq_hz) - 1;
+    if (wrap > 65535) wrap = 65535;
+
+    uint slice = bz->slice[tone->channel];
+    pwm_set_clkdiv_int_frac(slice, (uint8_t)div, 0);
+    pwm_set_wrap(slice, (uint16_t)wrap);
+    pwm_set_chan_level(slice, bz->chan[tone->channel], (uint16_t)((wrap + 1) / 2));
+}
+
+// Aplica o próximo passo do padrão; retorna sua duração em ms (0 = fim)
+static uint32_t advance(buzzer_pwm_t *bz) {
+    uint32_t start = time_us_32();
+    buzzer_tone_t tone;
+    uint32_t ms = buzzer_seq_next(&bz->seq, &tone);
+    apply_tone(bz, &tone);
+
+    uint32_t took = time_us_32() - start;
+    buzzer_trace_t *t = &bz->trace[bz->trace_head % BUZZER_TRACE_LEN];
+    t->time_us = start;
+    t->freq_hz = tone.freq_hz;
+    t->channel = tone.channel;
+    t->handler_us = took > 255 ? 255 : (uint8_t)took;
+    bz->trace_head++;
+    bz->steps++;
+    if (took > bz->worst_handler_us) bz->worst_handler_us = took;
+
+    if (!ms) bz->playing = false;
+    return ms;
+}
+
+static int64_t step_alarm(alarm_id_t id, void *user_data) {
+    buzzer_pwm_t *bz = (buzzer_pwm_t *)user_data;
+    (void)id;
+
+    uint32_t ms = advance(bz);
+    if (!ms) {
+        bz->alarm = 0;
+        return 0;
+    }
+    // Positivo: conta a partir do disparo anterior, sem acumular atraso
+    return (int64_t)ms * 1000;
+}
+
+// Cancela o alarme pendente. Chamar com IRQs desligadas
+static void cancel(buzzer_pwm_t *bz) {
+    if (bz->alarm > 0) alarm_pool_cancel_alarm(bz->pool, bz->alarm);
+    bz->alarm = 0;
+    bz->playing = false;
+}
+
+void buzzer_pwm_init(buzzer_pwm_t *bz, const uint *gpios, uint8_t count, alarm_pool_t *pool) {
+    if (count > BUZZER_MAX_CHANNELS) count = BUZZER_MAX_CHANNELS;
+    bz->count = count;
+    bz->pool = pool ? pool : alarm_pool_get_default();
+    bz->alarm = 0;
+    bz->playing = false;
+    bz->steps = 0;
+    bz->worst_handler_us = 0;
+    bz->trace_head = 0;
+    buzzer_seq_start(&bz->seq, NULL);
+
+    for (uint8_t i = 0; i < count; i++) {
+        bz->gpio[i] = gpios[i];
+        bz->slice[i] = pwm_gpio_to_slice_num(gpios[i]);
+        bz->chan[i] = pwm_gpio_to_channel(gpios[i]);
+        gpio_set_function(gpios[i], GPIO_FUNC_PWM);
+        pwm_set_chan_level(bz->slice[i], bz->chan[i], 0);
+        pwm_set_enabled(bz->slice[i], true);
+    }
+}
+
+void buzzer_play(buzzer_pwm_t *bz, const buzzer_pattern_t *pattern) {
+    uint32_t irq = save_and_disable_interrupts();
+    cancel(bz);
+    buzzer_seq_start(&bz->seq, pattern);
+    bz->playing = true;
+
+    // Primeiro passo aqui mesmo; os seguintes no alarme
+    uint32_t ms = advance(bz);
+    if (ms) {
+        bz->alarm = alarm_pool_add_alarm_in_us(bz->pool, (uint64_t)ms * 1000, step_alarm, bz, true);
+        if (bz->alarm < 0) {
+            bz->alarm = 0;
+            buzzer_stop(bz);
+        }
+    }
+    restore_interrupts(irq);
+}
+
+void buzzer_stop(buzzer_pwm_t *bz) {
+    uint32_t irq = save_and_disable_interrupts();
+    cancel(bz);
+    buzzer_seq_start(&bz->seq, NULL);
+    buzzer_tone_t silence = {0, 0};
+    apply_tone(bz, &silence);
+    restore_interrupts(irq);
+}
+
+bool buzzer_is_playing(const buzzer_pwm_t *bz) {
+    return bz->playing;
+}
+
+void buzzer_tone(buzzer_pwm_t *bz, uint8_t channel, uint16_t freq_hz) {
+    buzzer_stop(bz);
+    buzzer_tone_t tone = {channel, freq_hz};
+    apply_tone(bz, &tone);
+}
+
+uint8_t buzzer_get_trace(buzzer_pwm_t *bz, buzzer_trace_t *out, uint8_t max) {
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t head = bz->trace_head;
+    uint32_t n = head < BUZZER_TRACE_LEN ? head : BUZZER_TRACE_LEN;
+    if (n > max) n = max;
+    for (uint32_t i = 0; i < n; i++) out[i] = bz->trace[(head - n + i) % BUZZER_TRACE_LEN];
+    restore_interrupts(irq);
+    return (uint8_t)n;
+}
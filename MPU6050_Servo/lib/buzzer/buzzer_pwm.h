@@ -0,0 +1,59 @@
+#ifndef BUZZER_PWM_H
+#define BUZZER_PWM_H
+
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include "buzzer_pattern.h"
+
+// Buzzers (passivos) tocados por PWM de hardware, com o padrão sequenciado por
+// um alarme: buzzer_play() só agenda o primeiro passo e retorna; o laço
+// principal não dorme durante o alerta.
+//
+// O tom é gerado com 50% de ciclo no canal do buzzer. Canais na mesma fatia de
+// PWM (p.ex. GPIO10 e GPIO27, fatia 5) dividem a frequência: só um toca por vez,
+// o que os padrões alternados já respeitam.
+
+#define BUZZER_MAX_CHANNELS 4
+#define BUZZER_TRACE_LEN    16
+
+// Registro de cada passo aplicado, para conferir a temporização
+typedef struct {
+    uint32_t time_us;       // instante em que o tom foi aplicado
+    uint16_t freq_hz;
+    uint8_t channel;
+    uint8_t handler_us;     // tempo gasto no alarme (saturado em 255)
+} buzzer_trace_t;
+
+typedef struct {
+    uint gpio[BUZZER_MAX_CHANNELS];
+    uint slice[BUZZER_MAX_CHANNELS];
+    uint chan[BUZZER_MAX_CHANNELS];
+    uint8_t count;
+
+    alarm_pool_t *pool;
+    alarm_id_t alarm;
+    buzzer_seq_t seq;
+    volatile bool playing;
+
+    volatile uint32_t steps;
+    volatile uint32_t worst_handler_us;
+    buzzer_trace_t trace[BUZZER_TRACE_LEN];
+    volatile uint32_t trace_head;
+} buzzer_pwm_t;
+
+// Um canal por GPIO, na ordem dada. pool NULL usa o pool padrão de alarmes
+void buzzer_pwm_init(buzzer_pwm_t *bz, const uint *gpios, uint8_t count, alarm_pool_t *pool);
+
+// Toca o padrão do início (interrompe o atual). O padrão deve continuar válido
+// enquanto toca
+void buzzer_play(buzzer_pwm_t *bz, const buzzer_pattern_t *pattern);
+void buzzer_stop(buzzer_pwm_t *bz);
+bool buzzer_is_playing(const buzzer_pwm_t *bz);
+
+// Tom contínuo num canal (0 Hz silencia), fora de padrões
+void buzzer_tone(buzzer_pwm_t *bz, uint8_t channel, uint16_t freq_hz);
+
+// Copia até max registros do trace, do mais antigo ao mais novo; retorna quantos
+uint8_t buzzer_get_trace(buzzer_pwm_t *bz, buzzer_trace_t *out, uint8_t max);
+
+#endif
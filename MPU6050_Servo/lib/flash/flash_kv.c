@@ -0,0 +1,302 @@
+#include "flash_kv.h"
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include <stddef.h>
+#include <string.h>
+
+#define SECTOR_MAGIC 0x3153564B   // "KVS1"
+#define KV_FORMAT    1
+
+// Início de cada setor em uso
+typedef struct {
+    uint32_t magic;
+    uint32_t gen;       // geração: o setor de escrita é o de maior geração
+    uint32_t format;
+    uint32_t crc;       // dos campos acima
+} sector_hdr_t;
+
+// Registro: cabeçalho + valor completado com 0xFF até múltiplo de 4
+typedef struct {
+    uint8_t key;
+    uint8_t format;
+    uint16_t len;
+    uint32_t seq;       // versão: a maior vence
+    uint32_t crc;       // de key..seq e do valor
+} rec_hdr_t;
+
+#define ALIGN4(n)      (((n) + 3u) & ~3u)
+#define REC_SIZE(len)  (sizeof(rec_hdr_t) + ALIGN4(len))
+#define PAYLOAD        (FLASH_SECTOR_SIZE - sizeof(sector_hdr_t))
+
+// Registro montado antes de ir para a flash
+static uint8_t rec_buf[sizeof(rec_hdr_t) + FLASH_KV_VALUE_MAX];
+
+static uint32_t crc32(uint32_t crc, const void *data, size_t n) {
+    const uint8_t *p = data;
+    crc = ~crc;
+    while (n--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return ~crc;
+}
+
+static const uint8_t *flash_ptr(const flash_kv_t *kv, uint32_t addr) {
+    return (const uint8_t *)(XIP_BASE + kv->offset + addr);
+}
+
+static uint32_t sector_addr(uint8_t s) {
+    return (uint32_t)s * FLASH_SECTOR_SIZE;
+}
+
+// Grava página a página; os bytes fora do trecho vão como 0xFF e não alteram
+// o que já estava gravado na página
+static void program(flash_kv_t *kv, uint32_t addr, const uint8_t *data, uint32_t n) {
+    static uint8_t page[FLASH_PAGE_SIZE];
+
+    while (n) {
+        uint32_t page_addr = addr & ~(FLASH_PAGE_SIZE - 1);
+        uint32_t at = addr - page_addr;
+        uint32_t chunk = FLASH_PAGE_SIZE - at;
+        if (chunk > n) chunk = n;
+
+        memset(page, 0xFF, sizeof(page));
+        memcpy(page + at, data, chunk);
+
+        uint32_t ints = save_and_disable_interrupts();
+        flash_range_program(kv->offset + page_addr, page, FLASH_PAGE_SIZE);
+        restore_interrupts(ints);
+
+        addr += chunk;
+        data += chunk;
+        n -= chunk;
+    }
+}
+
+static void erase(flash_kv_t *kv, uint8_t s) {
+    uint32_t ints = save_and_disable_interrupts();
+    flash_range_erase(kv->offset + sector_addr(s), FLASH_SECTOR_SIZE);
+    restore_interrupts(ints);
+    kv->gen[s] = 0;
+    kv->erases++;
+}
+
+static bool erased(const flash_kv_t *kv, uint32_t addr, uint32_t end) {
+    const uint32_t *w = (const uint32_t *)flash_ptr(kv, addr);
+    for (uint32_t i = 0; i < (end - addr) / 4; i++) {
+        if (w[i] != 0xFFFFFFFFu) return false;
+    }
+    return true;
+}
+
+static uint32_t page_end(uint32_t addr) {
+    return (addr & ~(FLASH_PAGE_SIZE - 1)) + FLASH_PAGE_SIZE;
+}
+
+static bool sector_valid(const flash_kv_t *kv, uint8_t s, sector_hdr_t *h) {
+    memcpy(h, flash_ptr(kv, sector_addr(s)), sizeof(*h));
+    return h->magic == SECTOR_MAGIC && h->format == KV_FORMAT && h->gen != 0
+        && h->crc == crc32(0, h, offsetof(sector_hdr_t, crc));
+}
+
+// Registro íntegro em addr, sem passar de end?
+static bool rec_valid(const flash_kv_t *kv, uint32_t addr, uint32_t end, rec_hdr_t *h) {
+    if (addr + sizeof(rec_hdr_t) > end) return false;
+    memcpy(h, flash_ptr(kv, addr), sizeof(*h));
+    if (h->format != KV_FORMAT || h->key >= FLASH_KV_MAX_KEYS || h->len > FLASH_KV_VALUE_MAX) return false;
+    if (addr + REC_SIZE(h->len) > end) return false;
+
+    uint32_t crc = crc32(0, h, offsetof(rec_hdr_t, crc));
+    crc = crc32(crc, flash_ptr(kv, addr + sizeof(rec_hdr_t)), h->len);
+    return crc == h->crc;
+}
+
+static uint8_t free_sectors(const flash_kv_t *kv) {
+    uint8_t n = 0;
+    for (uint8_t s = 0; s < kv->sectors; s++) {
+        if (kv->gen[s] == 0) n++;
+    }
+    return n;
+}
+
+// Setor em uso mais antigo (fora o de escrita), ou -1
+static int oldest_sector(const flash_kv_t *kv) {
+    int oldest = -1;
+    for (uint8_t s = 0; s < kv->sectors; s++) {
+        if (kv->gen[s] == 0 || s == kv->head) continue;
+        if (oldest < 0 || kv->gen[s] < kv->gen[oldest]) oldest = s;
+    }
+    return oldest;
+}
+
+static bool in_sector(uint32_t addr, int s) {
+    return addr >= sector_addr(s) && addr < sector_addr(s) + FLASH_SECTOR_SIZE;
+}
+
+// Bytes ocupados pelos valores atuais (exceto a chave skip)
+static uint32_t live_bytes(const flash_kv_t *kv, int skip) {
+    uint32_t n = 0;
+    for (int k = 0; k < FLASH_KV_MAX_KEYS; k++) {
+        if (k != skip && kv->idx[k].addr) n += REC_SIZE(kv->idx[k].len);
+    }
+    return n;
+}
+
+// Acrescenta o registro no setor de escrita (que precisa ter espaço). O valor
+// pode estar na própria flash (compactação): é copiado antes de gravar
+static bool append(flash_kv_t *kv, uint8_t key, const void *value, uint16_t len) {
+    uint32_t size = REC_SIZE(len);
+    rec_hdr_t h = { .key = key, .format = KV_FORMAT, .len = len, .seq = kv->rec_seq + 1 };
+
+    memset(rec_buf, 0xFF, size);
+    memcpy(rec_buf + sizeof(h), value, len);
+    h.crc = crc32(crc32(0, &h, offsetof(rec_hdr_t, crc)), rec_buf + sizeof(h), len);
+    memcpy(rec_buf, &h, sizeof(h));
+
+    uint32_t addr = sector_addr(kv->head) + kv->wp;
+    program(kv, addr, rec_buf, size);
+    kv->wp += size;
+    kv->rec_seq = h.seq;
+
+    // Confere a gravação; falhando, continua na página seguinte (como a montagem)
+    rec_hdr_t check;
+    if (!rec_valid(kv, addr, sector_addr(kv->head) + FLASH_SECTOR_SIZE, &check)) {
+        kv->wp = page_end(addr + size - 1) - sector_addr(kv->head);
+        return false;
+    }
+    kv->idx[key].addr = addr;
+    kv->idx[key].seq = h.seq;
+    kv->idx[key].len = len;
+    return true;
+}
+
+// Copia os valores atuais do setor mais antigo para o de escrita e o apaga.
+// Um corte no meio deixa cópias com versão maior: nada se perde
+static bool compact(flash_kv_t *kv) {
+    int old = oldest_sector(kv);
+    if (old < 0) return false;
+
+    uint32_t need = 0;
+    for (int k = 0; k < FLASH_KV_MAX_KEYS; k++) {
+        if (kv->idx[k].addr && in_sector(kv->idx[k].addr, old)) need += REC_SIZE(kv->idx[k].len);
+    }
+    if (kv->wp + need > FLASH_SECTOR_SIZE) return false;
+
+    for (int k = 0; k < FLASH_KV_MAX_KEYS; k++) {
+        if (!kv->idx[k].addr || !in_sector(kv->idx[k].addr, old)) continue;
+        if (!append(kv, k, flash_ptr(kv, kv->idx[k].addr + sizeof(rec_hdr_t)), kv->idx[k].len)) return false;
+    }
+    erase(kv, old);
+    return true;
+}
+
+// Abre um setor apagado como setor de escrita. Se era o último livre, compacta
+// o mais antigo na hora para sempre sobrar um
+static bool open_sector(flash_kv_t *kv) {
+    int s = -1;
+    for (uint8_t i = 1; i <= kv->sectors && s < 0; i++) {
+        uint8_t c = (uint8_t)((kv->head + i + kv->sectors) % kv->sectors);
+        if (kv->gen[c] == 0) s = c;
+    }
+    if (s < 0) return false;
+
+    sector_hdr_t h = { .magic = SECTOR_MAGIC, .gen = kv->sector_seq + 1, .format = KV_FORMAT };
+    h.crc = crc32(0, &h, offsetof(sector_hdr_t, crc));
+    program(kv, sector_addr(s), (const uint8_t *)&h, sizeof(h));
+
+    kv->sector_seq = h.gen;
+    kv->gen[s] = h.gen;
+    kv->head = s;
+    kv->wp = sizeof(sector_hdr_t);
+
+    if (free_sectors(kv) == 0) compact(kv);
+    return true;
+}
+
+bool flash_kv_mount(flash_kv_t *kv, uint32_t offset, uint8_t sectors) {
+    if (sectors < 2 || sectors > FLASH_KV_MAX_SECTORS || offset % FLASH_SECTOR_SIZE) return false;
+
+    memset(kv, 0, sizeof(*kv));
+    kv->offset = offset;
+    kv->sectors = sectors;
+    kv->head = -1;
+
+    // Setores: em uso (cabeçalho válido), apagados, ou lixo de um apagamento
+    // ou abertura interrompidos (apagados de novo)
+    for (uint8_t s = 0; s < sectors; s++) {
+        sector_hdr_t h;
+        if (sector_valid(kv, s, &h)) {
+            kv->gen[s] = h.gen;
+            if (h.gen > kv->sector_seq) {
+                kv->sector_seq = h.gen;
+                kv->head = s;
+            }
+        } else if (!erased(kv, sector_addr(s), sector_addr(s) + FLASH_SECTOR_SIZE)) {
+            erase(kv, s);
+        }
+    }
+
+    // Registros: a maior versão de cada chave vence. A varredura de um setor
+    // para onde o resto da página está apagado. Um registro quebrado (gravação
+    // interrompida) só estraga as páginas que ele ocupa: a varredura, e a
+    // próxima gravação, seguem na página seguinte
+    for (uint8_t s = 0; s < sectors; s++) {
+        if (kv->gen[s] == 0) continue;
+
+        uint32_t addr = sector_addr(s) + sizeof(sector_hdr_t);
+        uint32_t end = sector_addr(s) + FLASH_SECTOR_SIZE;
+        while (addr + sizeof(rec_hdr_t) <= end) {
+            if (erased(kv, addr, page_end(addr))) break;
+
+            rec_hdr_t h;
+            if (!rec_valid(kv, addr, end, &h)) {
+                addr = page_end(addr);
+                continue;
+            }
+            if (h.seq > kv->idx[h.key].seq) {
+                kv->idx[h.key].addr = addr;
+                kv->idx[h.key].seq = h.seq;
+                kv->idx[h.key].len = h.len;
+            }
+            if (h.seq > kv->rec_seq) kv->rec_seq = h.seq;
+            addr += REC_SIZE(h.len);
+        }
+        if (s == kv->head) kv->wp = (addr < end ? addr : end) - sector_addr(s);
+    }
+
+    if (kv->head >= 0 && free_sectors(kv) == 0) compact(kv);
+    return true;
+}
+
+int flash_kv_get(const flash_kv_t *kv, uint8_t key, void *value, uint16_t size) {
+    if (key >= FLASH_KV_MAX_KEYS || !kv->idx[key].addr) return -1;
+
+    uint16_t len = kv->idx[key].len;
+    memcpy(value, flash_ptr(kv, kv->idx[key].addr + sizeof(rec_hdr_t)), len < size ? len : size);
+    return len;
+}
+
+bool flash_kv_set(flash_kv_t *kv, uint8_t key, const void *value, uint16_t len) {
+    if (key >= FLASH_KV_MAX_KEYS || len > FLASH_KV_VALUE_MAX) return false;
+
+    // Valor igual ao gravado: não gasta a flash
+    if (kv->idx[key].addr && kv->idx[key].len == len
+        && memcmp(flash_ptr(kv, kv->idx[key].addr + sizeof(rec_hdr_t)), value, len) == 0) {
+        return true;
+    }
+
+    // A compactação precisa caber num setor junto com as gravações novas
+    uint32_t size = REC_SIZE(len);
+    if (live_bytes(kv, key) + size > PAYLOAD / 2) return false;
+
+    if (kv->head < 0 || kv->wp + size > FLASH_SECTOR_SIZE) {
+        if (!open_sector(kv)) return false;
+    }
+    return append(kv, key, value, len);
+}
+
+bool flash_kv_maintain(flash_kv_t *kv) {
+    if (kv->head < 0 || free_sectors(kv) >= 2) return false;
+    return compact(kv);
+}
@@ -0,0 +1,60 @@
+#ifndef FLASH_KV_H
+#define FLASH_KV_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Armazenamento chave-valor em log sobre uma região de vários setores da flash.
+//
+// Cada gravação é um registro novo acrescentado ao setor de escrita (cabeçalho
+// com chave, tamanho e versão + valor + CRC32); nada é regravado no lugar. Um
+// registro só vale se o CRC conferir, então um corte de energia no meio da
+// gravação perde apenas aquele registro e o valor anterior continua valendo.
+// A montagem lê a região uma vez e monta na RAM um índice com a versão mais
+// nova de cada chave; a leitura depois disso é direta.
+//
+// Quando o setor de escrita enche, o próximo setor apagado é aberto. A
+// compactação copia os valores ainda atuais do setor mais antigo para o setor
+// de escrita e apaga o antigo; flash_kv_maintain() faz isso fora do caminho de
+// gravação, e ela só acontece durante uma gravação se não sobrar setor livre.
+// Assim cada setor é apagado uma vez a cada ~4 KiB gravados, e não a cada valor.
+
+#define FLASH_KV_MAX_KEYS    16
+#define FLASH_KV_MAX_SECTORS 16
+#define FLASH_KV_VALUE_MAX   512
+
+typedef struct {
+    uint32_t offset;        // início da região (a partir do início da flash)
+    uint8_t sectors;
+    int8_t head;            // setor de escrita (-1: região vazia)
+    uint32_t wp;            // próxima posição livre no setor de escrita
+    uint32_t sector_seq;    // última geração de setor aberta
+    uint32_t rec_seq;       // última versão de registro gravada
+    uint32_t erases;        // setores apagados desde a montagem
+    uint32_t gen[FLASH_KV_MAX_SECTORS];     // geração de cada setor (0: apagado)
+
+    // Versão mais nova de cada chave (addr relativo à região; 0: ausente)
+    struct {
+        uint32_t addr;
+        uint32_t seq;
+        uint16_t len;
+    } idx[FLASH_KV_MAX_KEYS];
+} flash_kv_t;
+
+// Monta a região (offset múltiplo do setor, 2..FLASH_KV_MAX_SECTORS setores):
+// uma varredura, que também apaga setores com apagamento interrompido
+bool flash_kv_mount(flash_kv_t *kv, uint32_t offset, uint8_t sectors);
+
+// Copia o valor da chave (até size bytes). Retorna o tamanho gravado, ou -1
+int flash_kv_get(const flash_kv_t *kv, uint8_t key, void *value, uint16_t size);
+
+// Grava uma nova versão da chave (valor igual ao atual não grava nada).
+// Os valores atuais somados devem caber em meio setor
+bool flash_kv_set(flash_kv_t *kv, uint8_t key, const void *value, uint16_t len);
+
+// Compactação em segundo plano: libera o setor mais antigo se restar só um
+// setor livre. Apaga um setor (~50 ms com interrupções desligadas); chamar com
+// o sistema ocioso. Retorna true se compactou
+bool flash_kv_maintain(flash_kv_t *kv);
+
+#endif
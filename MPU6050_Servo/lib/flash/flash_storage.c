@@ -1,39 +1,106 @@
 #include "flash_storage.h"
+#include "flash_kv.h"
 #include "hardware/flash.h"
-#include "hardware/sync.h"
 #include <string.h>
 
-#define FLASH_TARGET_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+// Região do armazenamento em log: FLASH_STORAGE_SECTORS setores logo abaixo do
+// último setor, onde ficava a página única das versões antigas
+#ifndef FLASH_STORAGE_SECTORS
+#define FLASH_STORAGE_SECTORS 4
+#endif
+#define LEGACY_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+#define KV_OFFSET     (LEGACY_OFFSET - FLASH_STORAGE_SECTORS * FLASH_SECTOR_SIZE)
+
+// Chaves no armazenamento
+enum {
+    KEY_CALIB = 1,
+    KEY_LUT = 2,
+};
 
+typedef struct {
+    uint32_t rotation_time_ms;
+    uint16_t confidence_pm;     // confiança da calibração (0: medida às cegas)
+} calib_rec_t;
+
+// Página única das versões antigas (só lida, para migrar)
 typedef struct {
     uint32_t magic;
     uint32_t rotation_time_ms;
-} calib_data_t;
+    uint32_t confidence_pm;
+    uint32_t lut_magic;
+    uint32_t lut_size;
+    uint8_t lut[FLASH_STORAGE_LUT_MAX];
+} legacy_page_t;
 
 #define MAGIC_KEY 0xABCD1234
+#define LUT_MAGIC 0x4C555431   // "LUT1"
+
+static flash_kv_t kv;
+static bool mounted;
+
+static bool rotation_valid(uint32_t rotation_time_ms) {
+    return rotation_time_ms >= 400 && rotation_time_ms <= 3000;
+}
+
+// Primeira montagem depois da atualização: copia a página antiga para o log.
+// A página não é apagada, então um corte aqui só repete a migração
+static void migrate_legacy(void) {
+    const legacy_page_t *old = (const legacy_page_t *)(XIP_BASE + LEGACY_OFFSET);
+    if (old->magic != MAGIC_KEY) return;
+
+    if (rotation_valid(old->rotation_time_ms)) {
+        calib_rec_t c;
+        memset(&c, 0, sizeof(c));   // sem lixo no preenchimento, como em flash_storage_write
+        c.rotation_time_ms = old->rotation_time_ms;
+        c.confidence_pm = old->confidence_pm <= 1000 ? old->confidence_pm : 0;
+        flash_kv_set(&kv, KEY_CALIB, &c, sizeof(c));
+    }
+    if (old->lut_magic == LUT_MAGIC && old->lut_size <= FLASH_STORAGE_LUT_MAX) {
+        flash_kv_set(&kv, KEY_LUT, old->lut, old->lut_size);
+    }
+}
 
-bool flash_storage_read(uint32_t *rotation_time_ms) {
-    const calib_data_t *data = (const calib_data_t *)(XIP_BASE + FLASH_TARGET_OFFSET);
+static flash_kv_t *store(void) {
+    if (!mounted) {
+        flash_kv_mount(&kv, KV_OFFSET, FLASH_STORAGE_SECTORS);
+        uint8_t probe;
+        if (flash_kv_get(&kv, KEY_CALIB, &probe, 0) < 0 && flash_kv_get(&kv, KEY_LUT, &probe, 0) < 0) {
+            migrate_legacy();
+        }
+        mounted = true;
+    }
+    return &kv;
+}
 
-    if (data->magic == MAGIC_KEY && data->rotation_time_ms >= 400 && data->rotation_time_ms <= 3000) {
-        *rotation_time_ms = data->rotation_time_ms;
-        return true;
+bool flash_storage_read(uint32_t *rotation_time_ms, uint16_t *confidence_pm) {
+    calib_rec_t c;
+    if (flash_kv_get(store(), KEY_CALIB, &c, sizeof(c)) != sizeof(c) || !rotation_valid(c.rotation_time_ms)) {
+        return false;
     }
-    return false;
+    *rotation_time_ms = c.rotation_time_ms;
+    if (confidence_pm) *confidence_pm = c.confidence_pm <= 1000 ? c.confidence_pm : 0;
+    return true;
 }
 
-void flash_storage_write(uint32_t rotation_time_ms) {
-    calib_data_t data = {
-        .magic = MAGIC_KEY,
-        .rotation_time_ms = rotation_time_ms
-    };
+void flash_storage_write(uint32_t rotation_time_ms, uint16_t confidence_pm) {
+    calib_rec_t c;
+    memset(&c, 0, sizeof(c));   // sem lixo no preenchimento: valor igual não regrava
+    c.rotation_time_ms = rotation_time_ms;
+    c.confidence_pm = confidence_pm;
+    flash_kv_set(store(), KEY_CALIB, &c, sizeof(c));
+}
+
+bool flash_storage_read_lut(void *lut, uint32_t size) {
+    // Confere o tamanho antes de copiar: tabela de outro formato não é usada
+    if (flash_kv_get(store(), KEY_LUT, lut, 0) != (int)size) return false;
+    return flash_kv_get(store(), KEY_LUT, lut, size) == (int)size;
+}
 
-    uint8_t page_buf[FLASH_PAGE_SIZE] = {0};
-    // gravamos apenas os primeiros bytes da página com nossa struct
-    memcpy(page_buf, &data, sizeof(data));
+bool flash_storage_write_lut(const void *lut, uint32_t size) {
+    if (size > FLASH_STORAGE_LUT_MAX) return false;
+    return flash_kv_set(store(), KEY_LUT, lut, size);
+}
 
-    uint32_t ints = save_and_disable_interrupts();
-    flash_range_erase(FLASH_TARGET_OFFSET, FLASH_SECTOR_SIZE);
-    flash_range_program(FLASH_TARGET_OFFSET, page_buf, FLASH_PAGE_SIZE);
-    restore_interrupts(ints);
+bool flash_storage_maintain(void) {
+    return flash_kv_maintain(store());
 }
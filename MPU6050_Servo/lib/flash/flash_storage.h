@@ -4,14 +4,39 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+// Calibração do servo guardada no armazenamento em log (flash_kv) dos últimos
+// setores da flash: cada gravação acrescenta um registro, sem apagar setor. Na
+// primeira leitura a página única das versões antigas é migrada.
+
+/**
+ * @brief Lê da flash o tempo de rotação calibrado (ms) e a confiança da
+ * calibração (0..1000, pode ser NULL). Retorna true se ok.
+ */
+bool flash_storage_read(uint32_t *rotation_time_ms, uint16_t *confidence_pm);
+
+/**
+ * @brief Grava na flash o tempo de rotação calibrado (ms) e sua confiança.
+ */
+void flash_storage_write(uint32_t rotation_time_ms, uint16_t confidence_pm);
+
+#define FLASH_STORAGE_LUT_MAX 236
+
+/**
+ * @brief Lê da flash a tabela de velocidade do servo (size bytes). Retorna false
+ * se não houver uma tabela gravada com esse tamanho.
+ */
+bool flash_storage_read_lut(void *lut, uint32_t size);
+
 /**
- * @brief Lê da flash o tempo de rotação calibrado (ms). Retorna true se ok.
+ * @brief Grava na flash a tabela de velocidade do servo (até FLASH_STORAGE_LUT_MAX
+ * bytes), preservando o tempo de rotação.
  */
-bool flash_storage_read(uint32_t *rotation_time_ms);
+bool flash_storage_write_lut(const void *lut, uint32_t size);
 
 /**
- * @brief Grava na flash o tempo de rotação calibrado (ms).
+ * @brief Compactação em segundo plano (pode apagar um setor, ~50 ms com as
+ * interrupções desligadas): chamar com o sistema ocioso. Retorna true se compactou.
  */
-void flash_storage_write(uint32_t rotation_time_ms);
+bool flash_storage_maintain(void);
 
 #endif
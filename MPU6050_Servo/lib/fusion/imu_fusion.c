@@ -0,0 +1,211 @@
+#include "imu_fusion.h"
+#include <stddef.h>
+
+#define Q24_ONE         (1 << 24)
+#define MUL24(a, b)     ((int32_t)(((int64_t)(a) * (b)) >> 24))
+#define DEG180_Q16      (180 << 16)
+#define DEG360_Q16      (360 << 16)
+#define MAX_DT_US       100000u     // acima disso o intervalo é tratado como uma pausa
+
+// atan(2^-i) em graus Q16
+static const int32_t cordic_atan_q16[16] = {
+    2949120, 1740967, 919879, 466945, 234379, 117304, 58666, 29335,
+    14668, 7334, 3667, 1833, 917, 458, 229, 115
+};
+#define CORDIC_GAIN_INV_Q16 39797   // 1 / 1.64676
+
+static uint32_t abs32(int32_t v) {
+    return v < 0 ? -(uint32_t)v : (uint32_t)v;
+}
+
+q16_t imu_fusion_atan2(int32_t y, int32_t x, int32_t *mag) {
+    if (x == 0 && y == 0) {
+        if (mag) *mag = 0;
+        return 0;
+    }
+
+    // Normaliza para |x|,|y| em [2^28, 2^29]: precisão máxima sem transbordar
+    uint32_t m = abs32(x) | abs32(y);
+    int shift = __builtin_clz(m) - 3;
+    if (shift >= 0) { x = (int32_t)((uint32_t)x << shift); y = (int32_t)((uint32_t)y << shift); }
+    else { x >>= -shift; y >>= -shift; }
+
+    // Semiplano esquerdo: gira 180° e compensa no fim
+    bool flip = x < 0;
+    if (flip) { x = -x; y = -y; }
+
+    int32_t angle = 0;
+    for (int i = 0; i < 16; i++) {
+        int32_t xs = x >> i, ys = y >> i;
+        if (y > 0) { x += ys; y -= xs; angle += cordic_atan_q16[i]; }
+        else       { x -= ys; y += xs; angle -= cordic_atan_q16[i]; }
+    }
+
+    if (mag) {
+        int64_t r = ((int64_t)x * CORDIC_GAIN_INV_Q16) >> 16;
+        *mag = (int32_t)(shift >= 0 ? r >> shift : r << -shift);
+    }
+    if (flip) {
+        angle += DEG180_Q16;
+        if (angle > DEG180_Q16) angle -= DEG360_Q16;
+    }
+    return angle;
+}
+
+static q16_t wrap180(q16_t a) {
+    if (a > DEG180_Q16) a -= DEG360_Q16;
+    else if (a <= -DEG180_Q16) a += DEG360_Q16;
+    return a;
+}
+
+static uint32_t isqrt64(uint64_t v) {
+    uint64_t r = 0, bit = 1ull << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= r + bit) { v -= r + bit; r = (r >> 1) + bit; }
+        else r >>= 1;
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+// Normaliza um vetor Q24 sem divisão: 1/sqrt por Newton com a soma dos
+// quadrados reescalada para [0.25, 1)
+static bool normalize(int32_t *v, int n) {
+    uint64_t sum = 0;
+    for (int i = 0; i < n; i++) sum += (int64_t)v[i] * v[i];
+    if (!sum) return false;
+
+    int len = 64 - __builtin_clzll(sum);
+    int k = (len - 47) >> 1;         // sum = m * 4^k, m em [2^46, 2^48)
+    uint64_t m = k >= 0 ? sum >> (2 * k) : sum << (-2 * k);
+
+    int64_t m_q28 = (int64_t)(m >> 20);
+    int64_t y = 483183821 - ((m_q28 * 13) >> 4);   // ~1.8 - 0.8m (Q28)
+    for (int i = 0; i < 4; i++) {
+        int64_t t = (m_q28 * ((y * y) >> 28)) >> 28;
+        y = (y * ((3LL << 28) - t)) >> 29;
+    }
+
+    for (int i = 0; i < n; i++) {
+        int64_t p = (int64_t)v[i] * y;
+        v[i] = (int32_t)(28 + k >= 0 ? p >> (28 + k) : p << -(28 + k));
+    }
+    return true;
+}
+
+// Ângulos do acelerômetro (sem o giroscópio)
+static void accel_angles(const int16_t accel[3], q16_t *pitch, q16_t *roll) {
+    int32_t mag_yz;
+    *roll = imu_fusion_atan2(accel[1], accel[2], &mag_yz);
+    *pitch = imu_fusion_atan2(-accel[0], mag_yz, NULL);
+}
+
+// Giro em graus Q16 no intervalo: raw * (250 << range) / 32768 °/s, exatamente
+// raw * (500 << range) em Q16 °/s; a divisão por 10^6 us vira * 4295 >> 32
+static q16_t gyro_delta(const imu_fusion_t *f, int16_t raw, uint32_t dt_us) {
+    int64_t dps_q16 = (int64_t)raw * (500 << f->gyro_range);
+    return (q16_t)((dps_q16 * dt_us * 4295) >> 32);
+}
+
+static void complementary_update(imu_fusion_t *f, const int16_t accel[3], const int16_t gyro[3],
+                                 uint32_t dt_us) {
+    q16_t pitch_acc, roll_acc;
+    accel_angles(accel, &pitch_acc, &roll_acc);
+
+    int32_t k = 32768 - f->alpha_q15;
+    f->pitch += gyro_delta(f, gyro[1], dt_us);
+    f->roll = wrap180(f->roll + gyro_delta(f, gyro[0], dt_us));
+    f->pitch += (q16_t)(((int64_t)wrap180(pitch_acc - f->pitch) * k) >> 15);
+    f->roll = wrap180(f->roll + (q16_t)(((int64_t)wrap180(roll_acc - f->roll) * k) >> 15));
+}
+
+static void madgwick_update(imu_fusion_t *f, const int16_t accel[3], const int16_t gyro[3],
+                            uint32_t dt_us) {
+    int32_t q0 = f->q[0], q1 = f->q[1], q2 = f->q[2], q3 = f->q[3];
+
+    // rad/s em Q24: raw * (250 << range) / 32768 * pi / 180 * 2^24 = raw * 2234.02 << range
+    int32_t gx = (gyro[0] * 2234) << f->gyro_range;
+    int32_t gy = (gyro[1] * 2234) << f->gyro_range;
+    int32_t gz = (gyro[2] * 2234) << f->gyro_range;
+
+    // Derivada do quaternion pelo giroscópio: 0.5 * q ⊗ (0, g)
+    int32_t qd0 = (-MUL24(q1, gx) - MUL24(q2, gy) - MUL24(q3, gz)) >> 1;
+    int32_t qd1 = (MUL24(q0, gx) + MUL24(q2, gz) - MUL24(q3, gy)) >> 1;
+    int32_t qd2 = (MUL24(q0, gy) - MUL24(q1, gz) + MUL24(q3, gx)) >> 1;
+    int32_t qd3 = (MUL24(q0, gz) + MUL24(q1, gy) - MUL24(q2, gx)) >> 1;
+
+    int32_t a[3] = { accel[0], accel[1], accel[2] };
+    if (normalize(a, 3)) {
+        int32_t ax = a[0], ay = a[1], az = a[2];
+        int32_t _2q0 = 2 * q0, _2q1 = 2 * q1, _2q2 = 2 * q2, _2q3 = 2 * q3;
+        int32_t _4q0 = 4 * q0, _4q1 = 4 * q1, _4q2 = 4 * q2;
+        int32_t _8q1 = 8 * q1, _8q2 = 8 * q2;
+        int32_t q0q0 = MUL24(q0, q0), q1q1 = MUL24(q1, q1);
+        int32_t q2q2 = MUL24(q2, q2), q3q3 = MUL24(q3, q3);
+
+        // Gradiente da função objetivo (gravidade estimada x medida)
+        int32_t s[4];
+        s[0] = MUL24(_4q0, q2q2) + MUL24(_2q2, ax) + MUL24(_4q0, q1q1) - MUL24(_2q1, ay);
+        s[1] = MUL24(_4q1, q3q3) - MUL24(_2q3, ax) + 4 * MUL24(q0q0, q1) - MUL24(_2q0, ay) - _4q1 +
+               MUL24(_8q1, q1q1) + MUL24(_8q1, q2q2) + MUL24(_4q1, az);
+        s[2] = 4 * MUL24(q0q0, q2) + MUL24(_2q0, ax) + MUL24(_4q2, q3q3) - MUL24(_2q3, ay) - _4q2 +
+               MUL24(_8q2, q1q1) + MUL24(_8q2, q2q2) + MUL24(_4q2, az);
+        s[3] = 4 * MUL24(q1q1, q3) - MUL24(_2q1, ax) + 4 * MUL24(q2q2, q3) - MUL24(_2q2, ay);
+
+        if (normalize(s, 4)) {
+            // Ganho alto no primeiro segundo para convergir a partir da identidade
+            int32_t beta = f->last_us - f->start_us < 1000000u ? Q24_ONE : f->beta_q24;
+            qd0 -= MUL24(beta, s[0]);
+            qd1 -= MUL24(beta, s[1]);
+            qd2 -= MUL24(beta, s[2]);
+            qd3 -= MUL24(beta, s[3]);
+        }
+    }
+
+    // dt em segundos Q24: dt_us * 2^24 / 10^6 = dt_us * 1099512 >> 16
+    int32_t dt = (int32_t)(((int64_t)dt_us * 1099512) >> 16);
+    f->q[0] = q0 + MUL24(qd0, dt);
+    f->q[1] = q1 + MUL24(qd1, dt);
+    f->q[2] = q2 + MUL24(qd2, dt);
+    f->q[3] = q3 + MUL24(qd3, dt);
+    normalize(f->q, 4);
+
+    q0 = f->q[0]; q1 = f->q[1]; q2 = f->q[2]; q3 = f->q[3];
+    int32_t sinp = 2 * (MUL24(q0, q2) - MUL24(q1, q3));
+    if (sinp > Q24_ONE) sinp = Q24_ONE;
+    if (sinp < -Q24_ONE) sinp = -Q24_ONE;
+    int32_t cosp = (int32_t)isqrt64((uint64_t)((int64_t)Q24_ONE * Q24_ONE - (int64_t)sinp * sinp));
+    f->pitch = imu_fusion_atan2(sinp, cosp, NULL);
+    f->roll = imu_fusion_atan2(2 * (MUL24(q0, q1) + MUL24(q2, q3)),
+                               Q24_ONE - 2 * (MUL24(q1, q1) + MUL24(q2, q2)), NULL);
+}
+
+void imu_fusion_init(imu_fusion_t *f, imu_fusion_mode_t mode, uint8_t gyro_range) {
+    f->mode = mode;
+    f->gyro_range = gyro_range & 3;
+    f->alpha_q15 = 32113;           // 0.98
+    f->beta_q24 = 1677722;          // 0.1
+    f->pitch = 0;
+    f->roll = 0;
+    f->q[0] = Q24_ONE;
+    f->q[1] = f->q[2] = f->q[3] = 0;
+    f->initialized = false;
+}
+
+void imu_fusion_update(imu_fusion_t *f, const int16_t accel[3], const int16_t gyro[3], uint32_t timestamp_us) {
+    if (!f->initialized) {
+        // Primeira amostra: parte do ângulo do acelerômetro
+        accel_angles(accel, &f->pitch, &f->roll);
+        f->last_us = f->start_us = timestamp_us;
+        f->initialized = true;
+        return;
+    }
+
+    uint32_t dt_us = timestamp_us - f->last_us;
+    f->last_us = timestamp_us;
+    if (dt_us > MAX_DT_US) dt_us = MAX_DT_US;
+
+    if (f->mode == IMU_FUSION_MADGWICK) madgwick_update(f, accel, gyro, dt_us);
+    else complementary_update(f, accel, gyro, dt_us);
+}
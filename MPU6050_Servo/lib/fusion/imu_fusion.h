@@ -0,0 +1,44 @@
+#ifndef IMU_FUSION_H
+#define IMU_FUSION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Estimativa de pitch/roll a partir de acelerômetro + giroscópio, toda em ponto
+// fixo (o Cortex-M0+ não tem FPU). Ângulos em graus Q16 (valor * 65536);
+// quaternion do Madgwick em Q24. Convenção: roll = atan2(ay, az),
+// pitch = atan2(-ax, sqrt(ay² + az²)); roll gira em X, pitch em Y.
+
+typedef int32_t q16_t;
+
+#define Q16_FROM_DEG(d)  ((q16_t)((d) * 65536))
+#define Q16_TO_INT(a)    (((a) + ((a) >= 0 ? 32768 : -32768)) / 65536)
+
+typedef enum {
+    IMU_FUSION_COMPLEMENTARY,   // barato: integra o gyro e corrige pelo ângulo do accel
+    IMU_FUSION_MADGWICK         // gradiente descendente sobre o quaternion
+} imu_fusion_mode_t;
+
+typedef struct {
+    imu_fusion_mode_t mode;
+    uint8_t gyro_range;         // 0=±250, 1=±500, 2=±1000, 3=±2000 °/s
+    int32_t alpha_q15;          // complementar: peso do giroscópio (0.98 -> 32113)
+    int32_t beta_q24;           // Madgwick: ganho de correção (0.1 -> 1677722)
+
+    q16_t pitch;                // saída, graus Q16
+    q16_t roll;
+
+    int32_t q[4];               // quaternion Q24 (Madgwick)
+    uint32_t last_us;
+    uint32_t start_us;
+    bool initialized;
+} imu_fusion_t;
+
+void imu_fusion_init(imu_fusion_t *f, imu_fusion_mode_t mode, uint8_t gyro_range);
+// Amostras brutas do MPU6050 (qualquer faixa do acelerômetro) e o instante da captura
+void imu_fusion_update(imu_fusion_t *f, const int16_t accel[3], const int16_t gyro[3], uint32_t timestamp_us);
+
+// atan2(y, x) em graus Q16 (-180..180] por CORDIC; se mag != NULL recebe |(x, y)|
+q16_t imu_fusion_atan2(int32_t y, int32_t x, int32_t *mag);
+
+#endif
@@ -1,6 +1,10 @@
 #include "mpu6050_i2c.h"
+#include "hardware/irq.h"
 
-
+// Configuração ativa (espelho dos registradores 0x19..0x1C) e fatores de escala
+static mpu6050_config_t config;
+static uint8_t accel_shift = 11, gyro_shift = 11;
+static uint8_t int_enable;      // espelho de INT_ENABLE (0x38)
 
 void mpu6050_setup_i2c() {
     i2c_init(I2C_PORT, 400*1000); // common options: 100*1000 (100 kHz) or 400*1000 (400 kHz)
@@ -20,6 +24,11 @@ void mpu6050_reset() {
     buf[1] = 0x00;
     i2c_write_blocking(I2C_PORT, MPU6050_ADDR, buf, 2, false);
     sleep_ms(10);
+
+    // Valores de reset: 8 kHz sem filtro, ±250 °/s e ±2 g
+    config = (mpu6050_config_t){0};
+    accel_shift = gyro_shift = 11;
+    int_enable = 0;
 }
 
 // Returns 0=±2g, 1=±4g, 2=±8g, 3=±16g
@@ -28,36 +37,391 @@ uint8_t mpu6050_get_accel_range() {
     uint8_t val;
     i2c_write_blocking(I2C_PORT, MPU6050_ADDR, &reg, 1, true);
     i2c_read_blocking(I2C_PORT, MPU6050_ADDR, &val, 1, false);
-    return (val >> 3) & 0x03; // bits 4:3
+    config.accel_range = (val >> 3) & 0x03; // bits 4:3
+    accel_shift = 11 - config.accel_range;
+    return config.accel_range;
 }
 
 // 0=±2g, 1=±4g, 2=±8g, 3=±16g
 void mpu6050_set_accel_range(uint8_t range) {
+    mpu6050_config_t cfg = config;
+    cfg.accel_range = range;
+    mpu6050_configure(&cfg);
+}
+
+// SMPLRT_DIV, CONFIG, GYRO_CONFIG e ACCEL_CONFIG são consecutivos: uma única
+// escrita com autoincremento aplica tudo
+bool mpu6050_configure(const mpu6050_config_t *cfg) {
+    uint8_t buf[5];
+    buf[0] = 0x19;
+    buf[1] = cfg->sample_div;
+    buf[2] = cfg->dlpf & 0x07;
+    buf[3] = (cfg->gyro_range & 0x03) << 3;
+    buf[4] = ((cfg->accel_range & 0x03) << 3) | (cfg->accel_hpf & 0x07);
+    if (i2c_write_blocking(I2C_PORT, MPU6050_ADDR, buf, 5, false) != 5) return false;
+
+    config = *cfg;
+    config.dlpf &= 0x07;
+    config.gyro_range &= 0x03;
+    config.accel_range &= 0x03;
+    config.accel_hpf &= 0x07;
+    // 1000 / (16384 >> r) = 125 / 2^(11 - r) mg; 250000 / (32768 >> r) = 15625 / 2^(11 - r) mdps
+    accel_shift = 11 - config.accel_range;
+    gyro_shift = 11 - config.gyro_range;
+    return true;
+}
+
+void mpu6050_get_config(mpu6050_config_t *cfg) {
+    *cfg = config;
+}
+
+uint32_t mpu6050_sample_period_us(void) {
+    // Com o DLPF ativo (1..6) o giroscópio amostra a 1 kHz; sem ele (0 ou 7), a 8 kHz
+    uint32_t base_hz = (config.dlpf == 0 || config.dlpf == 7) ? 8000 : 1000;
+    return (config.sample_div + 1) * 1000000u / base_hz;
+}
+
+// Converte para unidades inteiras com os fatores da faixa ativa, sem divisão
+void mpu6050_scale(const mpu6050_sample_t *raw, mpu6050_scaled_t *out) {
+    out->timestamp_us = raw->timestamp_us;
+    for (int i=0; i<3; i++) {
+        out->accel_mg[i] = (raw->accel[i] * 125) >> accel_shift;
+        out->gyro_mdps[i] = (raw->gyro[i] * 15625) >> gyro_shift;
+    }
+    // T = raw / 340 + 36.53 °C; 1000/340 ~ 48188 / 2^14
+    out->temp_mc = ((raw->temp * 48188) >> 14) + 36530;
+}
+
+static bool write_reg(uint8_t reg, uint8_t val) {
+    uint8_t buf[2] = {reg, val};
+    return i2c_write_blocking(I2C_PORT, MPU6050_ADDR, buf, 2, false) == 2;
+}
+
+static bool read_regs(uint8_t reg, uint8_t *buf, size_t len) {
+    if (i2c_write_blocking(I2C_PORT, MPU6050_ADDR, &reg, 1, true) < 0) return false;
+    return i2c_read_blocking(I2C_PORT, MPU6050_ADDR, buf, len, false) == (int)len;
+}
+
+// Decodifica os campos na ordem dos registradores (accel, temp, gyro), um após
+// o outro: é o formato tanto da leitura em rajada quanto de um quadro da FIFO
+static const uint8_t *decode_fields(const uint8_t *p, uint8_t fields, mpu6050_sample_t *sample) {
+    if (fields & MPU6050_ACCEL) {
+        for (int i=0; i<3; i++, p += 2)
+            sample->accel[i] = (p[0]<<8) | p[1];
+    }
+    if (fields & MPU6050_TEMP) {
+        sample->temp = (p[0]<<8) | p[1];
+        p += 2;
+    }
+    if (fields & MPU6050_GYRO) {
+        for (int i=0; i<3; i++, p += 2)
+            sample->gyro[i] = (p[0]<<8) | p[1];
+    }
+    sample->fields = fields;
+    return p;
+}
+
+static uint8_t fields_size(uint8_t fields) {
+    return ((fields & MPU6050_ACCEL) ? 6 : 0) + ((fields & MPU6050_TEMP) ? 2 : 0) +
+           ((fields & MPU6050_GYRO) ? 6 : 0);
+}
+
+// Lê em rajada os registradores de dados (0x3B accel, 0x41 temp, 0x43 gyro).
+// Só uma escrita de endereço + uma leitura, em vez de um par por grupo
+// Com status, a leitura começa um registrador antes (INT_STATUS 0x3A) e sempre
+// inclui o accel, para que a faixa continue contígua
+static bool burst_read(mpu6050_sample_t *sample, uint8_t fields, uint8_t *status) {
+    // Faixa contígua: accel em 0..5, temp em 6..7, gyro em 8..13
+    if (status) fields |= MPU6050_ACCEL;
+    uint8_t first = (fields & MPU6050_ACCEL) ? 0 : (fields & MPU6050_TEMP) ? 6 : 8;
+    uint8_t last = (fields & MPU6050_GYRO) ? 14 : (fields & MPU6050_TEMP) ? 8 : 6;
+    uint8_t covered = (first == 0 ? MPU6050_ACCEL : 0) |
+                      (first <= 6 && last >= 8 ? MPU6050_TEMP : 0) |
+                      (last == 14 ? MPU6050_GYRO : 0);
+    uint8_t skip = status ? 1 : 0;
+    uint8_t buffer[15];
+
+    sample->timestamp_us = time_us_32();
+    //MPU6050_REG_ACCEL_XOUT_H
+    if (!read_regs(0x3B + first - skip, buffer, last - first + skip)) return false;
+    if (status) *status = buffer[0];
+    decode_fields(buffer + skip, covered, sample);
+    return true;
+}
+
+bool mpu6050_read_sample(mpu6050_sample_t *sample, uint8_t fields) {
+    return burst_read(sample, fields, NULL);
+}
+
+// ==== FIFO ====
+// SMPLRT_DIV 0x19, CONFIG 0x1A, FIFO_EN 0x23, INT_STATUS 0x3A,
+// USER_CTRL 0x6A, FIFO_COUNTH/L 0x72/0x73, FIFO_R_W 0x74
+
+#define MPU6050_FIFO_SIZE     1024
+#define MPU6050_FIFO_CHUNK    8      // quadros lidos por rajada do FIFO_R_W
+
+// Ajusta SMPLRT_DIV e CONFIG mantendo as faixas; devolve o período real
+// (após a divisão inteira)
+static bool set_sample_rate(uint16_t rate_hz, uint8_t dlpf, uint32_t *period_us) {
+    uint32_t base_hz = dlpf ? 1000 : 8000;
+    uint32_t div = base_hz / rate_hz;
+    if (div < 1) div = 1;
+    if (div > 256) div = 256;
+
+    mpu6050_config_t cfg = config;
+    cfg.sample_div = (uint8_t)(div - 1);
+    cfg.dlpf = dlpf;
+    if (!mpu6050_configure(&cfg)) return false;
+    *period_us = mpu6050_sample_period_us();
+    return true;
+}
+
+static bool fifo_reset(void) {
+    // Desliga a FIFO, zera e religa: o próximo quadro começa alinhado
+    return write_reg(0x6A, 0x00) && write_reg(0x6A, 0x04) && write_reg(0x6A, 0x40);
+}
+
+bool mpu6050_fifo_start(mpu6050_fifo_t *fifo, uint16_t rate_hz, uint8_t dlpf, uint8_t fields) {
+    fields &= MPU6050_ALL;
+    if (!fields || !rate_hz || dlpf > 6) return false;
+
+    fifo->fields = fields;
+    fifo->frame_size = fields_size(fields);
+    fifo->dropped = 0;
+    fifo->overflows = 0;
+
+    uint8_t fifo_en = ((fields & MPU6050_TEMP) ? 0x80 : 0) |
+                      ((fields & MPU6050_GYRO) ? 0x70 : 0) |
+                      ((fields & MPU6050_ACCEL) ? 0x08 : 0);
+    uint8_t status;
+
+    if (!write_reg(0x23, 0x00)) return false;
+    if (!set_sample_rate(rate_hz, dlpf, &fifo->sample_period_us)) return false;
+    if (!fifo_reset()) return false;
+    read_regs(0x3A, &status, 1);     // limpa um overflow antigo
+    if (!write_reg(0x23, fifo_en)) return false;
+    fifo->last_drain_us = time_us_32();
+    return true;
+}
+
+void mpu6050_fifo_stop(mpu6050_fifo_t *fifo) {
+    (void)fifo;
+    write_reg(0x23, 0x00);
+    write_reg(0x6A, 0x00);
+}
+
+int mpu6050_fifo_count(void) {
     uint8_t buf[2];
-    buf[0] = 0x1C; // ACCEL_CONFIG register
-    buf[1] = range << 3; // bits 3 e 4
-    i2c_write_blocking(I2C_PORT, MPU6050_ADDR, buf, 2, false);
+    if (!read_regs(0x72, buf, 2)) return -1;
+    return (buf[0] << 8) | buf[1];
 }
 
-// le os dados brutos do acelerômetro, giroscópio e temperatura
-void mpu6050_read_raw(int16_t accel[3], int16_t gyro[3], int16_t *temp) {
-    uint8_t buffer[6];
-    uint8_t reg = 0x3B; //MPU6050_REG_ACCEL_XOUT_H
-    i2c_write_blocking(I2C_PORT, MPU6050_ADDR, &reg, 1, true);
-    i2c_read_blocking(I2C_PORT, MPU6050_ADDR, buffer, 6, false);
-    for (int i=0; i<3; i++)
-        accel[i] = (buffer[2*i]<<8) | buffer[2*i+1];
+int mpu6050_fifo_drain(mpu6050_fifo_t *fifo, spsc_ring_t *ring, uint16_t max) {
+    uint32_t now = time_us_32();
+    uint8_t status;
+    int count = mpu6050_fifo_count();
+    if (count < 0 || !read_regs(0x3A, &status, 1)) return -1;
 
-    reg = 0x43; //MPU6050_REG_GYRO_XOUT_H
-    i2c_write_blocking(I2C_PORT, MPU6050_ADDR, &reg, 1, true);
-    i2c_read_blocking(I2C_PORT, MPU6050_ADDR, buffer, 6, false);
-    for (int i=0; i<3; i++)
-        gyro[i] = (buffer[2*i]<<8) | buffer[2*i+1];
+    // Overflow (ou quadro desalinhado): os bytes mais antigos foram sobrescritos e
+    // o alinhamento se perdeu. Descarta tudo e conta as amostras do intervalo
+    if ((status & 0x10) || count >= MPU6050_FIFO_SIZE || count % fifo->frame_size) {
+        uint32_t lost = (now - fifo->last_drain_us) / fifo->sample_period_us;
+        uint32_t min_lost = MPU6050_FIFO_SIZE / fifo->frame_size;
+        fifo->dropped += lost > min_lost ? lost : min_lost;
+        fifo->overflows++;
+        fifo->last_drain_us = now;
+        return fifo_reset() ? 0 : -1;
+    }
 
-    reg = 0x41; //MPU6050_REG_TEMP_OUT_H
-    i2c_write_blocking(I2C_PORT, MPU6050_ADDR, &reg, 1, true);
-    i2c_read_blocking(I2C_PORT, MPU6050_ADDR, buffer, 2, false);
-    *temp = (buffer[0]<<8) | buffer[1];
+    uint16_t available = count / fifo->frame_size;
+    uint32_t space = spsc_ring_free(ring);
+    uint16_t n = available;
+    if (n > max) n = max;
+    if (n > space) n = space;
+
+    // Amostra mais recente ~ agora; as anteriores, um período antes cada
+    uint32_t ts = now - (uint32_t)(available - 1) * fifo->sample_period_us;
+    uint8_t buffer[MPU6050_FIFO_CHUNK * 14];
+
+    for (uint16_t done = 0; done < n; ) {
+        uint16_t chunk = n - done < MPU6050_FIFO_CHUNK ? n - done : MPU6050_FIFO_CHUNK;
+        if (!read_regs(0x74, buffer, chunk * fifo->frame_size)) return -1;
+
+        const uint8_t *p = buffer;
+        for (uint16_t i = 0; i < chunk; i++, ts += fifo->sample_period_us) {
+            mpu6050_sample_t *s = spsc_ring_claim(ring);
+            p = decode_fields(p, fifo->fields, s);
+            s->timestamp_us = ts;
+            spsc_ring_publish(ring);
+        }
+        done += chunk;
+    }
+
+    fifo->last_drain_us = now;
+    return n;
+}
+
+// ==== Aquisição por interrupção de dado pronto ====
+// INT_PIN_CFG 0x37, INT_ENABLE 0x38, INT_STATUS 0x3A
+
+static mpu6050_stream_t *stream;
+
+// Uma leitura em rajada (INT_STATUS + dados) por borda de subida do INT; a
+// própria leitura limpa o status no MPU6050 (INT_RD_CLEAR). O status separa
+// dado pronto de detecção de movimento, que compartilham o pino
+static void stream_irq_handler(void) {
+    mpu6050_stream_t *st = stream;
+    if (!st || !(gpio_get_irq_event_mask(st->gpio) & GPIO_IRQ_EDGE_RISE)) return;
+    gpio_acknowledge_irq(st->gpio, GPIO_IRQ_EDGE_RISE);
+
+    mpu6050_sample_t *s = spsc_ring_claim(st->ring);
+    mpu6050_sample_t discard;
+    uint8_t status;
+    if (!s) s = &discard;
+    if (!burst_read(s, st->fields, &status)) {
+        st->bus_errors++;
+        return;
+    }
+
+    if (status & 0x40) {
+        st->motion_events++;
+        st->last_motion_us = s->timestamp_us;
+    }
+    if (!(status & 0x01)) return;
+    if (s == &discard) {
+        // Anel cheio: a leitura ainda é feita para liberar o INT do sensor
+        st->ring->overruns++;
+        return;
+    }
+    spsc_ring_publish(st->ring);
+    st->samples++;
+}
+
+bool mpu6050_stream_start(mpu6050_stream_t *st, spsc_ring_t *ring, uint gpio,
+                          uint16_t rate_hz, uint8_t dlpf, uint8_t fields) {
+    fields &= MPU6050_ALL;
+    if (!fields || !rate_hz || dlpf > 6 || ring->elem_size != sizeof(mpu6050_sample_t)) return false;
+
+    st->ring = ring;
+    st->gpio = gpio;
+    st->fields = fields;
+    st->samples = 0;
+    st->bus_errors = 0;
+    st->motion_events = 0;
+    st->last_motion_us = 0;         // só vale depois do primeiro evento
+
+    if (!set_sample_rate(rate_hz, dlpf, &st->sample_period_us)) return false;
+    // INT ativo em nível alto, push-pull, pulso de 50 us, limpo por qualquer leitura
+    int_enable |= 0x01;             // DATA_RDY_EN
+    if (!write_reg(0x37, 0x10) || !write_reg(0x38, int_enable)) return false;
+
+    gpio_init(gpio);
+    gpio_set_dir(gpio, GPIO_IN);
+    stream = st;
+    gpio_add_raw_irq_handler(gpio, stream_irq_handler);
+    gpio_set_irq_enabled(gpio, GPIO_IRQ_EDGE_RISE, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+    return true;
+}
+
+void mpu6050_stream_stop(mpu6050_stream_t *st) {
+    gpio_set_irq_enabled(st->gpio, GPIO_IRQ_EDGE_RISE, false);
+    gpio_remove_raw_irq_handler(st->gpio, stream_irq_handler);
+    stream = NULL;
+    int_enable = 0;
+    write_reg(0x38, 0x00);
+}
+
+// A IRQ do stream também usa o I2C: reconfigurações com o stream ativo são
+// feitas com ela desligada (um pulso perdido só atrasa a próxima amostra)
+static void stream_pause(bool pause) {
+    if (stream) gpio_set_irq_enabled(stream->gpio, GPIO_IRQ_EDGE_RISE, !pause);
+}
+
+bool mpu6050_stream_set_rate(mpu6050_stream_t *st, uint16_t rate_hz) {
+    stream_pause(true);
+    bool ok = set_sample_rate(rate_hz, config.dlpf, &st->sample_period_us);
+    stream_pause(false);
+    return ok;
+}
+
+// ==== Detecção de movimento ====
+// MOT_THR 0x1F (2 mg/LSB), MOT_DUR 0x20 (1 ms/LSB). O detector compara a saída
+// do filtro passa-altas do acelerômetro (ACCEL_HPF), que precisa estar ativo
+bool mpu6050_motion_enable(uint16_t threshold_mg, uint8_t duration_ms) {
+    uint16_t thr = threshold_mg / 2;
+    if (thr == 0) thr = 1;
+    if (thr > 255) thr = 255;
+
+    mpu6050_config_t cfg = config;
+    if (cfg.accel_hpf == 0) cfg.accel_hpf = 1;  // 5 Hz
+    uint8_t buf[3] = {0x1F, (uint8_t)thr, duration_ms ? duration_ms : 1};
+
+    stream_pause(true);
+    int_enable |= 0x40;             // MOT_EN
+    bool ok = mpu6050_configure(&cfg) &&
+              i2c_write_blocking(I2C_PORT, MPU6050_ADDR, buf, 3, false) == 3 &&
+              write_reg(0x37, 0x10) && write_reg(0x38, int_enable);
+    stream_pause(false);
+    return ok;
+}
+
+void mpu6050_motion_disable(void) {
+    stream_pause(true);
+    int_enable &= ~0x40;
+    write_reg(0x38, int_enable);
+    stream_pause(false);
+}
+
+// ==== Amostragem adaptativa ====
+
+void mpu6050_adaptive_init(mpu6050_adaptive_t *ad, uint16_t idle_hz, uint16_t active_hz,
+                           uint32_t quiet_ms, uint32_t now_us) {
+    ad->idle_hz = idle_hz;
+    ad->active_hz = active_hz;
+    ad->quiet_ms = quiet_ms;
+    ad->active = false;
+    ad->mode_start_us = ad->last_update_us = now_us;
+    ad->last_samples = 0;
+    ad->last_events = 0;
+    ad->time_us[0] = ad->time_us[1] = 0;
+    ad->samples[0] = ad->samples[1] = 0;
+    ad->switches = 0;
+}
+
+bool mpu6050_adaptive_update(mpu6050_adaptive_t *ad, mpu6050_stream_t *st, uint32_t now_us) {
+    // Contabiliza o intervalo desde a última chamada no modo em que ele ocorreu
+    uint32_t samples = st->samples;
+    ad->time_us[ad->active] += now_us - ad->last_update_us;
+    ad->samples[ad->active] += samples - ad->last_samples;
+    ad->last_update_us = now_us;
+    ad->last_samples = samples;
+
+    // Só um evento novo liga o modo ativo: sem movimento desde o boot o stream
+    // fica em repouso, e o contador de 32 bits dando a volta (~71 min) não
+    // faz um evento antigo parecer recente
+    uint32_t events = st->motion_events;
+    bool moving = events != ad->last_events ||
+                  (ad->active && now_us - st->last_motion_us < ad->quiet_ms * 1000u);
+    ad->last_events = events;
+    if (moving == ad->active) return false;
+
+    ad->active = moving;
+    ad->mode_start_us = now_us;
+    ad->switches++;
+    mpu6050_stream_set_rate(st, moving ? ad->active_hz : ad->idle_hz);
+    return true;
+}
+
+// le os dados brutos do acelerômetro, giroscópio e temperatura
+void mpu6050_read_raw(int16_t accel[3], int16_t gyro[3], int16_t *temp) {
+    mpu6050_sample_t s = {0};  // em caso de falha no barramento devolve zeros
+    mpu6050_read_sample(&s, MPU6050_ALL);
+    for (int i=0; i<3; i++) {
+        accel[i] = s.accel[i];
+        gyro[i] = s.gyro[i];
+    }
+    *temp = s.temp;
 }
 
 // Função para testar o MPU6050
@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "spsc_ring.h"
 
 #define I2C_PORT i2c0
 #define I2C_SDA 0
@@ -16,10 +17,121 @@
 #define ACCEL_SENS_8G  4096.0f
 #define ACCEL_SENS_16G 2048.0f
 
+// Campos de uma amostra, combináveis em máscara
+#define MPU6050_ACCEL (1u << 0)
+#define MPU6050_TEMP  (1u << 1)
+#define MPU6050_GYRO  (1u << 2)
+#define MPU6050_ALL   (MPU6050_ACCEL | MPU6050_TEMP | MPU6050_GYRO)
+
+// Amostra decodificada, na mesma ordem dos registradores 0x3B..0x48.
+// Sem padding interno (20 bytes), mantendo os campos alinhados
+typedef struct {
+    uint32_t timestamp_us;  // time_us_32() no início da leitura
+    int16_t accel[3];
+    int16_t temp;
+    int16_t gyro[3];
+    uint8_t fields;         // campos válidos (pode incluir mais que os pedidos)
+} mpu6050_sample_t;
+
 void mpu6050_setup_i2c(void);
 void mpu6050_reset(void);
 uint8_t mpu6050_get_accel_range(void); // Returns 0=±2g, 1=±4g, 2=±8g, 3=±16g
 void mpu6050_set_accel_range(uint8_t range) ; // 0=±2g, 1=±4g, 2=±8g, 3=±16g
+
+// Configuração de aquisição (registradores 0x19..0x1C)
+typedef struct {
+    uint8_t sample_div;     // SMPLRT_DIV: taxa = base / (1 + div); base 1 kHz com DLPF, 8 kHz sem
+    uint8_t dlpf;           // CONFIG.DLPF_CFG: 0 = 260 Hz (sem filtro) ... 6 = 5 Hz
+    uint8_t gyro_range;     // 0=±250, 1=±500, 2=±1000, 3=±2000 °/s
+    uint8_t accel_range;    // 0=±2g, 1=±4g, 2=±8g, 3=±16g
+    uint8_t accel_hpf;      // ACCEL_HPF (usado só pela detecção de movimento): 0 = off, 1 = 5 Hz ... 4 = 0.63 Hz
+} mpu6050_config_t;
+
+// Amostra em unidades inteiras
+typedef struct {
+    uint32_t timestamp_us;
+    int32_t accel_mg[3];    // mili-g
+    int32_t gyro_mdps[3];   // mili-graus/s
+    int32_t temp_mc;        // mili-°C
+} mpu6050_scaled_t;
+
+// Aplica tudo numa única escrita e guarda as faixas para a conversão de escala
+bool mpu6050_configure(const mpu6050_config_t *cfg);
+void mpu6050_get_config(mpu6050_config_t *cfg);
+uint32_t mpu6050_sample_period_us(void);
+// Converte com multiplicação + deslocamento pré-calculados para as faixas ativas
+void mpu6050_scale(const mpu6050_sample_t *raw, mpu6050_scaled_t *out);
+// Lê numa única transação a faixa contígua de registradores que cobre os campos pedidos
+bool mpu6050_read_sample(mpu6050_sample_t *sample, uint8_t fields);
+
+// ==== FIFO de hardware (1024 bytes) ====
+// O sensor amostra no ritmo de SMPLRT_DIV e empilha os campos escolhidos na FIFO;
+// o loop principal drena vários quadros por rajada, sem ler amostra a amostra.
+typedef struct {
+    uint8_t fields;             // campos empilhados por amostra
+    uint8_t frame_size;         // bytes por amostra na FIFO
+    uint32_t sample_period_us;  // período real (após a divisão inteira)
+    uint32_t last_drain_us;
+    uint32_t dropped;           // amostras perdidas por overflow (estimado pelo tempo)
+    uint32_t overflows;         // quantas vezes a FIFO transbordou e foi reiniciada
+} mpu6050_fifo_t;
+
+// dlpf: CONFIG.DLPF_CFG (0..6); com 1..6 a taxa base é 1 kHz (0: 8 kHz, só gyro útil)
+bool mpu6050_fifo_start(mpu6050_fifo_t *fifo, uint16_t rate_hz, uint8_t dlpf, uint8_t fields);
+void mpu6050_fifo_stop(mpu6050_fifo_t *fifo);
+// Bytes na FIFO, ou -1 em erro de barramento
+int mpu6050_fifo_count(void);
+// Move até max amostras para o anel (de mpu6050_sample_t), limitado ao espaço livre,
+// em rajadas. Em overflow reinicia a FIFO, soma as perdidas em fifo->dropped e
+// retorna 0. -1 em erro de barramento
+int mpu6050_fifo_drain(mpu6050_fifo_t *fifo, spsc_ring_t *ring, uint16_t max);
+
+// ==== Aquisição por interrupção (pino INT -> IRQ de GPIO) ====
+// A cada dado pronto a IRQ lê a amostra em rajada e a publica no anel; o loop
+// consome no próprio ritmo. Enquanto ativa, só a IRQ (e as funções mpu6050_stream_*,
+// mpu6050_motion_* e mpu6050_adaptive_*) usam o I2C do sensor.
+typedef struct {
+    spsc_ring_t *ring;          // anel de mpu6050_sample_t (overruns: anel cheio)
+    uint gpio;
+    uint8_t fields;
+    uint32_t sample_period_us;
+    volatile uint32_t samples;  // amostras publicadas
+    volatile uint32_t bus_errors;
+    volatile uint32_t motion_events;   // interrupções de movimento
+    volatile uint32_t last_motion_us;
+} mpu6050_stream_t;
+
+bool mpu6050_stream_start(mpu6050_stream_t *st, spsc_ring_t *ring, uint gpio,
+                          uint16_t rate_hz, uint8_t dlpf, uint8_t fields);
+void mpu6050_stream_stop(mpu6050_stream_t *st);
+// Troca a taxa com o stream ativo (mantém DLPF e faixas)
+bool mpu6050_stream_set_rate(mpu6050_stream_t *st, uint16_t rate_hz);
+
+// Detecção de movimento no mesmo pino INT: a IRQ do stream registra os eventos.
+// Liga o passa-altas do acelerômetro (5 Hz) se estiver desligado
+bool mpu6050_motion_enable(uint16_t threshold_mg, uint8_t duration_ms);
+void mpu6050_motion_disable(void);
+
+// Amostragem adaptativa: taxa baixa em repouso, alta a partir de um evento de
+// movimento, voltando ao repouso após quiet_ms sem eventos. Começa em repouso
+typedef struct {
+    uint16_t idle_hz, active_hz;
+    uint32_t quiet_ms;
+    bool active;
+    uint32_t mode_start_us;
+    uint32_t last_update_us;
+    uint32_t last_samples;
+    uint32_t last_events;       // motion_events na última chamada
+    uint64_t time_us[2];        // tempo acumulado [repouso, ativo]
+    uint32_t samples[2];        // amostras recebidas em cada modo
+    uint32_t switches;
+} mpu6050_adaptive_t;
+
+// Comece o stream já na taxa idle_hz
+void mpu6050_adaptive_init(mpu6050_adaptive_t *ad, uint16_t idle_hz, uint16_t active_hz,
+                           uint32_t quiet_ms, uint32_t now_us);
+// Chame periodicamente no loop; retorna true se o modo mudou
+bool mpu6050_adaptive_update(mpu6050_adaptive_t *ad, mpu6050_stream_t *st, uint32_t now_us);
 void mpu6050_read_raw(int16_t accel[3], int16_t gyro[3], int16_t *temp);
 bool mpu6050_test(void);
 
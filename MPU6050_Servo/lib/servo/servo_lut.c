@@ -0,0 +1,84 @@
+#include "servo_lut.h"
+#include <math.h>
+
+#define LUT_PULSE_MIN  1100
+#define LUT_PULSE_STEP 50
+
+void servo_lut_init_linear(servo_lut_t *lut, float full_dps) {
+    lut->pulse_min_us = LUT_PULSE_MIN;
+    lut->pulse_step_us = LUT_PULSE_STEP;
+    lut->count = SERVO_LUT_POINTS;
+    float half = (SERVO_LUT_POINTS - 1) / 2.0f;
+    for (uint8_t i = 0; i < SERVO_LUT_POINTS; i++) {
+        lut->dps[i] = full_dps * (i - half) / half;
+    }
+}
+
+bool servo_lut_fit(servo_lut_t *lut, float deadband_dps) {
+    uint8_t n = lut->count;
+    if (n < 3) return false;
+
+    // Giro para o lado errado: o sensor está invertido em relação ao servo
+    if (lut->dps[n - 1] < lut->dps[0]) {
+        for (uint8_t i = 0; i < n; i++) lut->dps[i] = -lut->dps[i];
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        if (fabsf(lut->dps[i]) < deadband_dps) lut->dps[i] = 0;
+    }
+
+    // Monotonia a partir do centro: o ruído não pode criar duas soluções no inverso
+    uint8_t mid = n / 2;
+    for (uint8_t i = mid + 1; i < n; i++) {
+        if (lut->dps[i] < lut->dps[i - 1]) lut->dps[i] = lut->dps[i - 1];
+    }
+    for (int i = mid - 1; i >= 0; i--) {
+        if (lut->dps[i] > lut->dps[i + 1]) lut->dps[i] = lut->dps[i + 1];
+    }
+    return servo_lut_valid(lut);
+}
+
+bool servo_lut_valid(const servo_lut_t *lut) {
+    if (lut->count < 3 || lut->count > SERVO_LUT_POINTS || lut->pulse_step_us == 0) return false;
+    for (uint8_t i = 1; i < lut->count; i++) {
+        if (!(lut->dps[i] >= lut->dps[i - 1])) return false;   // também rejeita NaN
+    }
+    return lut->dps[0] < 0 && lut->dps[lut->count - 1] > 0;
+}
+
+float servo_lut_speed(const servo_lut_t *lut, float pulse_us) {
+    float pos = (pulse_us - lut->pulse_min_us) / lut->pulse_step_us;
+    if (pos <= 0) return lut->dps[0];
+    if (pos >= lut->count - 1) return lut->dps[lut->count - 1];
+
+    uint8_t i = (uint8_t)pos;
+    float frac = pos - i;
+    return lut->dps[i] + (lut->dps[i + 1] - lut->dps[i]) * frac;
+}
+
+float servo_lut_pulse(const servo_lut_t *lut, float dps) {
+    uint8_t n = lut->count;
+    if (dps >= lut->dps[n - 1]) return servo_lut_pulse_at(lut, n - 1);
+    if (dps <= lut->dps[0]) return servo_lut_pulse_at(lut, 0);
+
+    if (dps == 0) {
+        // Centro da faixa de pulsos que não gira
+        uint8_t first = 0, last = n - 1;
+        while (first < n - 1 && lut->dps[first] < 0) first++;
+        while (last > 0 && lut->dps[last] > 0) last--;
+        return (servo_lut_pulse_at(lut, first) + servo_lut_pulse_at(lut, last)) / 2.0f;
+    }
+
+    // Primeiro segmento que contém dps, do lado certo da zona morta
+    for (uint8_t i = 0; i < n - 1; i++) {
+        float a = lut->dps[i], b = lut->dps[i + 1];
+        if (dps >= a && dps <= b && b > a) {
+            return servo_lut_pulse_at(lut, i) + (dps - a) / (b - a) * lut->pulse_step_us;
+        }
+    }
+    return servo_lut_pulse(lut, 0);
+}
+
+float servo_lut_max_speed(const servo_lut_t *lut, int dir) {
+    return dir > 0 ? lut->dps[lut->count - 1] : -lut->dps[0];
+}
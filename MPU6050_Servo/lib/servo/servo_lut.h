@@ -0,0 +1,42 @@
+#ifndef SERVO_LUT_H
+#define SERVO_LUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Modelo de velocidade de um servo contínuo: velocidade medida (graus/s) em
+// pulsos igualmente espaçados. Entre os pontos a velocidade é interpolada. Depois
+// de servo_lut_fit() a tabela é monotônica (pulso maior = ângulo crescendo), com
+// a zona morta em torno do neutro zerada; assim ela também serve ao contrário:
+// velocidade desejada -> pulso. Sem dependência de hardware.
+
+#define SERVO_LUT_POINTS 17     // 1100..1900 us em passos de 50 us
+
+typedef struct {
+    uint16_t pulse_min_us;
+    uint16_t pulse_step_us;
+    uint8_t count;
+    float dps[SERVO_LUT_POINTS];
+} servo_lut_t;
+
+// Modelo linear (sem calibração): full_dps nos extremos, zero no centro
+void servo_lut_init_linear(servo_lut_t *lut, float full_dps);
+
+static inline uint16_t servo_lut_pulse_at(const servo_lut_t *lut, uint8_t i) {
+    return lut->pulse_min_us + i * lut->pulse_step_us;
+}
+
+// Ajusta a tabela medida: inverte o sinal se o sensor estiver montado ao contrário,
+// zera a zona morta (|dps| < deadband_dps) e força a monotonia.
+// Retorna false se a tabela não tiver giro nos dois sentidos
+bool servo_lut_fit(servo_lut_t *lut, float deadband_dps);
+bool servo_lut_valid(const servo_lut_t *lut);
+
+// Velocidade esperada para o pulso (graus/s)
+float servo_lut_speed(const servo_lut_t *lut, float pulse_us);
+// Pulso que dá a velocidade pedida (satura nos extremos; 0 = centro da zona morta)
+float servo_lut_pulse(const servo_lut_t *lut, float dps);
+// Maior velocidade no sentido dir (+1/-1), em módulo
+float servo_lut_max_speed(const servo_lut_t *lut, int dir);
+
+#endif
@@ -1,61 +1,183 @@
 #include "servo_sim.h"
 #include <math.h>
+#include "hardware/sync.h"
 
-// Configuração do PWM: 50 Hz, 1 tick = 1us
+// PWM a 50 Hz pelo banco de servos (divisor calculado do clock do sistema)
 void servo_sim_init(servo_sim_t *servo, uint gpio, float rotation_time_ms) {
     servo->gpio = gpio;
     servo->stop_pulse_us = 1500.0f;
     servo->speed_scale = 500.0f; // ±500us
     servo->current_angle = 90.0f; // posição inicial “meio”
     servo->deg_per_ms = 180.0f / rotation_time_ms;
+    servo->lut = NULL;
+    servo->moving = false;
+    servo->alarm = 0;
 
-    gpio_set_function(gpio, GPIO_FUNC_PWM);
-    servo->slice = pwm_gpio_to_slice_num(gpio);
-    servo->channel = pwm_gpio_to_channel(gpio);
+    servo->bank = servo_bank_default();
+    servo->ch = servo_bank_add(servo->bank, gpio);
+    servo_bank_start(servo->bank);
+}
 
-    float clk_div = 125.0f; // 125MHz / 125 = 1MHz → 1us por tick
-    servo->top = 20000;     // 20ms = 50Hz
+static void servo_set_pulse(servo_sim_t *servo, float pulse_us) {
+    if (pulse_us < 1000.0f) pulse_us = 1000.0f;
+    if (pulse_us > 2000.0f) pulse_us = 2000.0f;
 
-    pwm_set_clkdiv(servo->slice, clk_div);
-    pwm_set_wrap(servo->slice, servo->top);
-    pwm_set_enabled(servo->slice, true);
+    servo_bank_write(servo->bank, servo->ch, pulse_us);
 }
 
 static void servo_set_speed(servo_sim_t *servo, float speed) {
     if (speed > 1.0f) speed = 1.0f;
     if (speed < -1.0f) speed = -1.0f;
 
-    float pulse_us = servo->stop_pulse_us + speed * servo->speed_scale;
-    if (pulse_us < 1000.0f) pulse_us = 1000.0f;
-    if (pulse_us > 2000.0f) pulse_us = 2000.0f;
+    servo_set_pulse(servo, servo->stop_pulse_us + speed * servo->speed_scale);
+}
+
+// Posição estimada pelo tempo decorrido desde o início do movimento
+static float estimate_angle(const servo_sim_t *servo, uint32_t now_us) {
+    if (!servo->moving) return servo->current_angle;
+
+    float travel = servo->move_dpms * (float)(now_us - servo->move_start_us) / 1000.0f;
+    float angle = servo->current_angle + servo->dir * travel;
+    // Não passa do alvo (o alarme pode estar chegando)
+    if (servo->dir > 0 ? angle > servo->target_angle : angle < servo->target_angle) {
+        angle = servo->target_angle;
+    }
+    return angle;
+}
+
+// Alarme de fim de giro (IRQ)
+static int64_t stop_alarm(alarm_id_t id, void *user_data) {
+    servo_sim_t *servo = (servo_sim_t *)user_data;
+    (void)id;
+
+    servo_set_speed(servo, 0);
+    servo->current_angle = servo->target_angle;
+    servo->moving = false;
+    servo->alarm = 0;
+    return 0;
+}
 
-    uint16_t level = (uint16_t)((pulse_us / 20000.0f) * servo->top);
-    pwm_set_chan_level(servo->slice, servo->channel, level);
+// Cancela o alarme e congela a posição estimada. Chamar com IRQs desligadas
+static void halt(servo_sim_t *servo, uint32_t now_us) {
+    if (servo->alarm > 0) cancel_alarm(servo->alarm);
+    servo->alarm = 0;
+    servo->current_angle = estimate_angle(servo, now_us);
+    servo->moving = false;
 }
 
 void servo_sim_set_angle(servo_sim_t *servo, float target_angle) {
     if (target_angle < 0) target_angle = 0;
     if (target_angle > 180) target_angle = 180;
 
-    float delta = target_angle - servo->current_angle;
+    // O alarme não pode disparar entre a estimativa e o novo agendamento
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t now = time_us_32();
+    halt(servo, now);
 
+    float delta = target_angle - servo->current_angle;
     if (fabsf(delta) < 0.5f) {  // deadband
+        servo_set_speed(servo, 0);
+        restore_interrupts(irq);
+        return;
+    }
+
+    int8_t dir = (delta > 0) ? 1 : -1;
+    float pulse_us = servo->stop_pulse_us + dir * servo->speed_scale;
+    float dpms = servo->deg_per_ms;
+    if (servo->lut) {
+        // Feed-forward: pulso para a velocidade desejada e a velocidade que ele
+        // realmente dá (a curva não é linear nem simétrica)
+        float dps = fabsf(delta) * 1000.0f / SERVO_SIM_MIN_MOVE_MS;
+        float max = servo_lut_max_speed(servo->lut, dir);
+        if (dps > max) dps = max;
+        pulse_us = servo_lut_pulse(servo->lut, dir * dps);
+        dpms = fabsf(servo_lut_speed(servo->lut, pulse_us)) / 1000.0f;
+    }
+    uint64_t time_us = dpms > 0 ? (uint64_t)(fabsf(delta) / dpms * 1000.0f) : 0;
+
+    servo->dir = dir;
+    servo->move_dpms = dpms;
+    servo->target_angle = target_angle;
+    servo->move_start_us = now;
+    servo->alarm = add_alarm_in_us(time_us, stop_alarm, servo, false);
+    if (servo->alarm <= 0) {
+        // Sem alarme livre (ou tempo curto demais): considera o alvo alcançado
         servo_set_speed(servo, 0);
         servo->current_angle = target_angle;
+        restore_interrupts(irq);
         return;
     }
+    servo->moving = true;
+    servo_set_pulse(servo, pulse_us);
+    restore_interrupts(irq);
+}
+
+float servo_sim_get_angle(servo_sim_t *servo) {
+    uint32_t irq = save_and_disable_interrupts();
+    float angle = estimate_angle(servo, time_us_32());
+    restore_interrupts(irq);
+    return angle;
+}
 
-    float speed = (delta > 0) ? 1.0f : -1.0f;
-    float time_ms = fabsf(delta) / servo->deg_per_ms;
+bool servo_sim_is_moving(const servo_sim_t *servo) {
+    return servo->moving;
+}
 
-    servo_set_speed(servo, speed);
-    sleep_ms((uint32_t)(time_ms + 0.5f));
+void servo_sim_stop(servo_sim_t *servo) {
+    uint32_t irq = save_and_disable_interrupts();
+    halt(servo, time_us_32());
     servo_set_speed(servo, 0);
+    restore_interrupts(irq);
+}
 
-    servo->current_angle = target_angle;
+void servo_sim_wait(servo_sim_t *servo) {
+    while (servo->moving) tight_loop_contents();
 }
 
-void servo_sim_calibrate(servo_sim_t *servo) {
+#define CALIB_STEP_MS   10      // janela de cada medida integrada
+#define CALIB_STALL_DPS 20.0f   // abaixo disso, depois de girar, é fim de curso
+#define CALIB_STALL_MS  100
+#define CALIB_MIN_DEG   10.0f   // giro mínimo para a corrida valer
+
+// Uma corrida em velocidade máxima no sentido dir. Retorna o tempo para 180° (ms),
+// ou 0 se o eixo não girou
+static float calib_run(servo_sim_t *servo, int8_t dir, servo_measure_fn_t measure_dps, void *ctx,
+                       float *net_deg, bool *end_stop) {
+    float angle = 0;
+    uint32_t stall_us = 0;
+    uint32_t start = time_us_32(), last = start;
+    *end_stop = false;
+
+    servo_set_speed(servo, dir);
+    while (time_us_32() - start < SERVO_CALIB_TIMEOUT_MS * 1000u) {
+        float rate = measure_dps(ctx, CALIB_STEP_MS) * dir;   // positivo no sentido pedido
+        uint32_t now = time_us_32();
+        uint32_t dt = now - last;
+        angle += rate * (float)dt / 1e6f;
+        last = now;
+
+        if (angle >= 180.0f) break;
+        if (angle > CALIB_MIN_DEG && rate < CALIB_STALL_DPS) {
+            stall_us += dt;
+            if (stall_us >= CALIB_STALL_MS * 1000u) {
+                *end_stop = true;
+                break;
+            }
+        } else {
+            stall_us = 0;
+        }
+    }
+    servo_set_speed(servo, 0);
+
+    *net_deg += dir * angle;
+    if (angle < CALIB_MIN_DEG) return 0;
+    // Tempo até o último instante em movimento, proporcional ao ângulo coberto
+    float elapsed_ms = (float)(last - start - stall_us) / 1000.0f;
+    return elapsed_ms * 180.0f / angle;
+}
+
+// Estimativa sem sensor: só o tempo de giro (não mede o servo)
+static void calibrate_blind(servo_sim_t *servo, servo_calib_t *result) {
     // Vai “para 0°” (giro negativo por 500ms para encostar)
     servo_set_speed(servo, -1.0f);
     sleep_ms(500);
@@ -77,4 +199,81 @@ void servo_sim_calibrate(servo_sim_t *servo) {
 
     servo->deg_per_ms = 180.0f / (float)elapsed_ms;
     servo->current_angle = 180.0f;
+
+    result->rotation_time_ms = (float)elapsed_ms;
+    result->runs = 1;
+}
+
+bool servo_sim_calibrate(servo_sim_t *servo, servo_measure_fn_t measure_dps, void *ctx,
+                         uint8_t runs, servo_calib_t *result) {
+    servo_sim_stop(servo);
+    result->rotation_time_ms = 0;
+    result->stddev_ms = 0;
+    result->runs = 0;
+    result->end_stops = 0;
+    result->confidence_pm = 0;
+
+    if (!measure_dps) {
+        calibrate_blind(servo, result);
+        return true;
+    }
+
+    // Média e variância por sentido (Welford): a diferença entre os sentidos é do
+    // servo, não erro de medida, e não entra na confiança
+    float mean[2] = {0, 0}, m2[2] = {0, 0}, net_deg = 0;
+    uint8_t n[2] = {0, 0};
+    for (uint8_t i = 0; i < runs; i++) {
+        uint8_t k = i & 1;
+        bool end_stop;
+        float t = calib_run(servo, k ? -1 : 1, measure_dps, ctx, &net_deg, &end_stop);
+        sleep_ms(300);
+        if (t <= 0) continue;
+
+        result->runs++;
+        if (end_stop) result->end_stops++;
+        n[k]++;
+        float d = t - mean[k];
+        mean[k] += d / n[k];
+        m2[k] += d * (t - mean[k]);
+    }
+
+    // Posição relativa ao início das corridas
+    float angle = servo->current_angle + net_deg;
+    servo->current_angle = angle < 0 ? 0 : angle > 180 ? 180 : angle;
+    if (!result->runs) return false;
+
+    // Média dos dois sentidos; desvio padrão combinado dentro de cada sentido
+    float avg = (n[0] && n[1]) ? (mean[0] + mean[1]) / 2 : n[0] ? mean[0] : mean[1];
+    uint8_t dof = (n[0] ? n[0] - 1 : 0) + (n[1] ? n[1] - 1 : 0);
+    float stddev = dof ? sqrtf((m2[0] + m2[1]) / dof) : avg;   // uma corrida por sentido: sem confiança
+    float penalty = 10.0f * 1000.0f * stddev / avg;
+    result->rotation_time_ms = avg;
+    result->stddev_ms = stddev;
+    result->confidence_pm = penalty >= 1000.0f ? 0 : (uint16_t)(1000.0f - penalty);
+    servo->deg_per_ms = 180.0f / avg;
+    return true;
+}
+
+void servo_sim_set_lut(servo_sim_t *servo, const servo_lut_t *lut) {
+    servo_sim_stop(servo);
+    servo->lut = (lut && servo_lut_valid(lut)) ? lut : NULL;
+    // O neutro passa a ser o centro da zona morta medida
+    servo->stop_pulse_us = servo->lut ? servo_lut_pulse(lut, 0) : 1500.0f;
+    servo_set_speed(servo, 0);
+}
+
+bool servo_sim_identify(servo_sim_t *servo, servo_lut_t *lut, servo_measure_fn_t measure_dps, void *ctx) {
+    servo_sim_stop(servo);
+    servo_lut_init_linear(lut, 0);
+
+    for (uint8_t i = 0; i < lut->count; i++) {
+        servo_set_pulse(servo, servo_lut_pulse_at(lut, i));
+        sleep_ms(200);                          // servo acelera até a velocidade do pulso
+        lut->dps[i] = measure_dps(ctx, 300);
+    }
+    servo_set_pulse(servo, servo->stop_pulse_us);
+
+    // 5% da maior velocidade: abaixo disso é ruído do sensor ou zona morta
+    float peak = fmaxf(fabsf(lut->dps[0]), fabsf(lut->dps[lut->count - 1]));
+    return servo_lut_fit(lut, peak * 0.05f);
 }
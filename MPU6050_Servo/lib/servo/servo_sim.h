@@ -2,17 +2,26 @@
 #define SERVO_SIM_H
 
 #include "pico/stdlib.h"
-#include "hardware/pwm.h"
+#include "servo_bank.h"
+#include "servo_lut.h"
 
 typedef struct {
     uint gpio;
-    uint slice;
-    uint channel;
-    uint16_t top;
+    servo_bank_t *bank;
+    int ch;                 // canal no banco
     float stop_pulse_us;    // pulso neutro (~1500us)
     float speed_scale;      // faixa de controle (±500us)
-    float current_angle;    // posição simulada atual
+    float current_angle;    // posição no início do movimento em curso (ou parado)
     float deg_per_ms;       // graus por milissegundo (calibrado)
+    const servo_lut_t *lut; // modelo de velocidade medido (NULL: linear, deg_per_ms)
+
+    // Movimento em curso: o alarme para o PWM ao chegar no alvo
+    volatile bool moving;
+    int8_t dir;             // +1 / -1
+    float move_dpms;        // velocidade prevista do movimento em curso (graus/ms)
+    float target_angle;
+    uint32_t move_start_us;
+    alarm_id_t alarm;
 } servo_sim_t;
 
 /**
@@ -22,14 +31,67 @@ typedef struct {
 void servo_sim_init(servo_sim_t *servo, uint gpio, float rotation_time_ms);
 
 /**
- * Move até ângulo simulado (0..180) usando rotação por tempo
+ * Inicia o movimento até o ângulo simulado (0..180) e retorna na hora: um alarme
+ * de hardware para o servo ao fim do tempo de giro. Um novo alvo durante o
+ * movimento parte da posição estimada naquele instante
  */
 void servo_sim_set_angle(servo_sim_t *servo, float target_angle);
 
 /**
- * Calibração automática: mede tempo de 0° a 180° e atualiza deg_per_ms
- * (usa velocidade máxima; bloqueante por ~1.7s)
+ * Posição estimada agora (interpolada durante o movimento)
+ */
+float servo_sim_get_angle(servo_sim_t *servo);
+
+bool servo_sim_is_moving(const servo_sim_t *servo);
+
+/**
+ * Para imediatamente na posição estimada
+ */
+void servo_sim_stop(servo_sim_t *servo);
+
+/**
+ * Espera o movimento em curso terminar (comportamento bloqueante antigo)
+ */
+void servo_sim_wait(servo_sim_t *servo);
+
+// Medida de velocidade angular do eixo: média (graus/s) durante window_ms
+typedef float (*servo_measure_fn_t)(void *ctx, uint32_t window_ms);
+
+typedef struct {
+    float rotation_time_ms;     // tempo para 180° em velocidade máxima (média dos dois sentidos)
+    float stddev_ms;            // desvio padrão entre corridas no mesmo sentido
+    uint8_t runs;               // corridas válidas
+    uint8_t end_stops;          // corridas encerradas por fim de curso
+    uint16_t confidence_pm;     // 0..1000: 1000 - 10 x variação relativa (em ‰)
+} servo_calib_t;
+
+#define SERVO_CALIB_TIMEOUT_MS 3000   // limite de cada corrida
+
+/**
+ * Calibração: gira em velocidade máxima integrando measure_dps (p.ex. giro Z do
+ * MPU6050 preso ao eixo) até completar 180° ou parar num fim de curso, e mede o
+ * tempo real, normalizado para 180°. Faz `runs` corridas alternando o sentido e
+ * atualiza deg_per_ms com a média. Sem measure_dps apenas estima pelo tempo do
+ * giro (confiança 0). Retorna false se nenhuma corrida detectou movimento
+ */
+bool servo_sim_calibrate(servo_sim_t *servo, servo_measure_fn_t measure_dps, void *ctx,
+                         uint8_t runs, servo_calib_t *result);
+
+/**
+ * Usa o modelo de velocidade medido: o pulso de cada movimento sai do inverso
+ * da tabela e a posição estimada usa a velocidade prevista para esse pulso.
+ * Movimentos curtos ficam mais lentos, durando pelo menos SERVO_SIM_MIN_MOVE_MS
+ * (alguns quadros do PWM), para não passar do alvo. lut deve continuar válida
+ */
+#define SERVO_SIM_MIN_MOVE_MS 60
+void servo_sim_set_lut(servo_sim_t *servo, const servo_lut_t *lut);
+
+/**
+ * Mede a curva de velocidade: varre os pulsos da tabela e, em cada um, chama
+ * measure_dps (p.ex. média do giro Z do MPU6050 preso ao eixo) após o servo
+ * estabilizar. Termina com servo_lut_fit(); retorna false se a curva não for
+ * válida. Bloqueante por ~SERVO_LUT_POINTS * 0.5 s
  */
-void servo_sim_calibrate(servo_sim_t *servo);
+bool servo_sim_identify(servo_sim_t *servo, servo_lut_t *lut, servo_measure_fn_t measure_dps, void *ctx);
 
 #endif
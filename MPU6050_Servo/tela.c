@@ -0,0 +1,66 @@
+#include "tela.h"
+#include "ssd1306_widget.h"
+#include "ssd1306_sparkline.h"
+
+// Widgets da tela principal: só os campos que mudam são redesenhados
+static ssd1306_label_t lbl_titulo = SSD1306_LABEL(20, 0, "Servo MPU6050");
+static ssd1306_label_t lbl_ax = SSD1306_LABEL(6, 20, "AX:");
+static ssd1306_label_t lbl_ang = SSD1306_LABEL(6, 36, "Ang:");
+static ssd1306_number_t num_ax = SSD1306_NUMBER(30, 20, 5, 2, "g");
+static ssd1306_number_t num_atual = SSD1306_NUMBER(36, 36, 3, 0, "/");
+static ssd1306_number_t num_alvo = SSD1306_NUMBER(60, 36, 3, 0, NULL);
+// Alerta na última página: rola como letreiro pelo próprio controlador
+static ssd1306_label_t lbl_alerta = SSD1306_LABEL(6, 56, "");
+#define ALERT_PAGE (56 / 8)
+
+// Tela do gráfico: histórico de AX (em mg) nas páginas 1..7
+static ssd1306_label_t lbl_grafico = SSD1306_LABEL(16, 0, "Historico AX");
+static ssd1306_sparkline_t graf_ax = SSD1306_SPARKLINE(0, SSD1306_WIDTH, 1, 7, 500);
+
+void tela_montar(ssd1306_t *oled, bool grafico) {
+    ssd1306_scroll_stop(oled);
+    ssd1306_clear(oled);
+    ssd1306_label_reset(&lbl_titulo);
+    ssd1306_label_reset(&lbl_ax);
+    ssd1306_label_reset(&lbl_ang);
+    ssd1306_label_reset(&lbl_alerta);
+    ssd1306_label_reset(&lbl_grafico);
+    ssd1306_number_reset(&num_ax);
+    ssd1306_number_reset(&num_atual);
+    ssd1306_number_reset(&num_alvo);
+
+    if (grafico) {
+        ssd1306_label_draw(oled, &lbl_grafico);
+        ssd1306_sparkline_draw(oled, &graf_ax);
+    } else {
+        ssd1306_label_draw(oled, &lbl_titulo);
+        ssd1306_label_draw(oled, &lbl_ax);
+        ssd1306_label_draw(oled, &lbl_ang);
+    }
+}
+
+void tela_atualizar(ssd1306_t *oled, bool grafico, int32_t ax_mg, float atual, float alvo) {
+    if (grafico) return;
+    ssd1306_number_set_fixed(oled, &num_ax, ax_mg / 10);  // centésimos de g
+    ssd1306_number_set(oled, &num_atual, atual);
+    ssd1306_number_set(oled, &num_alvo, alvo);
+}
+
+void tela_historico(ssd1306_t *oled, bool grafico, const int32_t *ax_mg, uint16_t n) {
+    for (uint16_t i = 0; i < n; i++) {
+        // Só as colunas novas (e a folga à frente) são desenhadas e enviadas
+        if (grafico) ssd1306_sparkline_push(oled, &graf_ax, ax_mg[i]);
+        else ssd1306_sparkline_add(&graf_ax, ax_mg[i]);
+    }
+}
+
+void tela_alerta(ssd1306_t *oled, const char *msg) {
+    if (msg) {
+        ssd1306_label_set(oled, &lbl_alerta, msg);
+        ssd1306_scroll_start(oled, SSD1306_SCROLL_LEFT, ALERT_PAGE, ALERT_PAGE,
+                             SSD1306_SCROLL_3_FRAMES);
+    } else {
+        ssd1306_scroll_stop(oled);
+        ssd1306_label_set(oled, &lbl_alerta, "");
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef TELA_H
+#define TELA_H
+
+#include "ssd1306.h"
+
+// Telas do OLED: valores (AX e ângulos, com alerta em letreiro) e histórico de
+// AX. Só desenham no buffer; o envio fica com quem chama (agendador de
+// quadros no firmware, emulador nos testes de host)
+
+// Limpa o display e desenha o texto fixo da tela escolhida
+void tela_montar(ssd1306_t *oled, bool grafico);
+
+// Na tela de valores redesenha os campos que mudaram; no gráfico não faz nada
+void tela_atualizar(ssd1306_t *oled, bool grafico, int32_t ax_mg, float atual, float alvo);
+
+// Amostras de AX consumidas desde a última chamada, um ponto do histórico por
+// amostra. Gravadas nas duas telas; no gráfico só as colunas novas são desenhadas
+void tela_historico(ssd1306_t *oled, bool grafico, const int32_t *ax_mg, uint16_t n);
+
+// Alerta na última página da tela de valores, rolado pelo próprio SSD1306
+// (só comandos na entrada e na saída); msg NULL apaga
+void tela_alerta(ssd1306_t *oled, const char *msg);
+
+#endif
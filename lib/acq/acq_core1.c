@@ -0,0 +1,132 @@
+#include "acq_core1.h"
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+
+// Instância atendida pelo core1
+static acq_t *runtime;
+
+void acq_load_begin(acq_load_t *load, uint32_t now_us) {
+    if (load->window_start_us == 0) load->window_start_us = now_us;
+    load->busy_start_us = now_us;
+}
+
+void acq_load_end(acq_load_t *load, uint32_t now_us) {
+    load->busy_us += now_us - load->busy_start_us;
+
+    uint32_t elapsed = now_us - load->window_start_us;
+    if (elapsed < ACQ_LOAD_WINDOW_US) return;
+
+    uint32_t busy = load->busy_us > elapsed ? elapsed : load->busy_us;
+    load->permille = (uint16_t)(((uint64_t)busy * 1000) / elapsed);
+    load->window_start_us = now_us;
+    load->busy_us = 0;
+}
+
+static void source_poll(acq_source_t *src, uint32_t now_us) {
+    uint32_t scratch[ACQ_DATA_MAX / 4];
+
+    // A leitura (que pode bloquear) vai para um buffer privado; o trecho
+    // protegido pelo seqlock é só a cópia
+    bool ok = src->read(src->ctx, scratch);
+    uint32_t done_us = time_us_32();
+    uint32_t took = done_us - now_us;
+
+    if (ok) {
+        seqlock_write_begin(&src->lock);
+        memcpy(src->data, scratch, src->size);
+        src->timestamp_us = done_us;
+        seqlock_write_end(&src->lock);
+        src->stats.reads++;
+    } else {
+        src->stats.errors++;
+    }
+    src->stats.last_read_us = took;
+    if (took > src->stats.worst_read_us) src->stats.worst_read_us = took;
+
+    // Mantém a cadência; se a leitura atrasou mais de um período, recomeça a contar
+    src->next_us += src->period_us;
+    if ((int32_t)(done_us - src->next_us) >= 0) src->next_us = done_us + src->period_us;
+}
+
+static void core1_main(void) {
+    acq_t *acq = runtime;
+    uint32_t now = time_us_32();
+
+    for (uint8_t i = 0; i < acq->count; i++) acq->sources[i].next_us = now;
+
+    while (acq->running) {
+        now = time_us_32();
+        acq_load_begin(&acq->load, now);
+
+        uint32_t wake = now + ACQ_LOAD_WINDOW_US;
+        for (uint8_t i = 0; i < acq->count; i++) {
+            acq_source_t *src = &acq->sources[i];
+            if ((int32_t)(time_us_32() - src->next_us) >= 0) source_poll(src, time_us_32());
+            if ((int32_t)(src->next_us - wake) < 0) wake = src->next_us;
+        }
+
+        now = time_us_32();
+        acq_load_end(&acq->load, now);
+        if ((int32_t)(wake - now) > 0) sleep_us(wake - now);
+    }
+    acq->stopped = true;
+}
+
+void acq_init(acq_t *acq) {
+    memset(acq, 0, sizeof(*acq));
+}
+
+int acq_add_source(acq_t *acq, acq_read_fn_t read, void *ctx, uint16_t size, uint32_t period_ms) {
+    if (acq->count >= ACQ_MAX_SOURCES || size > ACQ_DATA_MAX || acq->running) return -1;
+
+    acq_source_t *src = &acq->sources[acq->count];
+    memset(src, 0, sizeof(*src));
+    src->read = read;
+    src->ctx = ctx;
+    src->size = size;
+    src->period_us = period_ms * 1000;
+    seqlock_init(&src->lock);
+    return acq->count++;
+}
+
+void acq_start(acq_t *acq) {
+    runtime = acq;
+    acq->stopped = false;
+    acq->running = true;
+    multicore_launch_core1(core1_main);
+}
+
+void acq_stop(acq_t *acq) {
+    acq->running = false;
+    while (!acq->stopped) tight_loop_contents();
+    multicore_reset_core1();
+    runtime = NULL;
+}
+
+bool acq_read(const acq_t *acq, int source, void *data, uint32_t *age_us) {
+    const acq_source_t *src = &acq->sources[source];
+    uint32_t seq, timestamp;
+
+    do {
+        seq = seqlock_read_begin(&src->lock);
+        memcpy(data, src->data, src->size);
+        timestamp = src->timestamp_us;
+    } while (seqlock_read_retry(&src->lock, seq));
+
+    if (seq == 0) return false;
+    if (age_us) *age_us = time_us_32() - timestamp;
+    return true;
+}
+
+uint32_t acq_version(const acq_t *acq, int source) {
+    return seqlock_version(&acq->sources[source].lock);
+}
+
+void acq_get_stats(const acq_t *acq, int source, acq_source_stats_t *stats) {
+    memcpy(stats, (const void *)&acq->sources[source].stats, sizeof(*stats));
+}
+
+uint16_t acq_core1_load(const acq_t *acq) {
+    return acq->load.permille;
+}
@@ -0,0 +1,85 @@
+#ifndef ACQ_CORE1_H
+#define ACQ_CORE1_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "seqlock.h"
+
+// Aquisição no core1: o core1 passa a ser o dono do barramento dos sensores e
+// chama as leituras (bloqueantes: esperas de conversão, inicializações longas)
+// no período de cada fonte. Cada leitura é feita num buffer privado e só depois
+// publicada no snapshot da fonte, protegido por seqlock. O core0 (tela, rede)
+// lê a última amostra sem trava e sem esperar o sensor.
+//
+// Registre as fontes e use o barramento dos sensores no core0 (init dos sensores)
+// só antes de acq_start().
+
+#define ACQ_MAX_SOURCES 4
+#define ACQ_DATA_MAX    32      // bytes de dado por fonte
+
+// Leitura da fonte, executada no core1. Preenche data (size bytes); false em falha
+typedef bool (*acq_read_fn_t)(void *ctx, void *data);
+
+// Ocupação de um core: tempo entre acq_load_begin() e acq_load_end() sobre o
+// tempo total, fechada em janelas de ACQ_LOAD_WINDOW_US
+#define ACQ_LOAD_WINDOW_US 1000000u
+
+typedef struct {
+    uint32_t window_start_us;
+    uint32_t busy_start_us;
+    uint32_t busy_us;
+    volatile uint16_t permille;     // ocupação da última janela (0..1000)
+} acq_load_t;
+
+typedef struct {
+    uint32_t reads;             // leituras publicadas
+    uint32_t errors;            // leituras que falharam (snapshot mantido)
+    uint32_t last_read_us;      // duração da última leitura
+    uint32_t worst_read_us;
+} acq_source_stats_t;
+
+typedef struct {
+    acq_read_fn_t read;
+    void *ctx;
+    uint16_t size;
+    uint32_t period_us;
+    uint32_t next_us;           // próxima leitura (só o core1)
+
+    // Snapshot publicado
+    seqlock_t lock;
+    uint32_t timestamp_us;      // instante da leitura
+    uint32_t data[ACQ_DATA_MAX / 4];
+
+    volatile acq_source_stats_t stats;
+} acq_source_t;
+
+typedef struct {
+    acq_source_t sources[ACQ_MAX_SOURCES];
+    uint8_t count;
+    volatile bool running;
+    volatile bool stopped;
+    acq_load_t load;            // ocupação do core1 (inclui as esperas dentro das leituras)
+} acq_t;
+
+void acq_init(acq_t *acq);
+// Retorna o índice da fonte, ou -1 (sem espaço ou size > ACQ_DATA_MAX)
+int acq_add_source(acq_t *acq, acq_read_fn_t read, void *ctx, uint16_t size, uint32_t period_ms);
+
+// Lança o laço de aquisição no core1 (uma instância por vez)
+void acq_start(acq_t *acq);
+// Espera a leitura em andamento terminar e reinicia o core1
+void acq_stop(acq_t *acq);
+
+// Core0: copia a última amostra publicada da fonte. Retorna false se ainda não
+// houve nenhuma. age_us (pode ser NULL) recebe a idade da amostra
+bool acq_read(const acq_t *acq, int source, void *data, uint32_t *age_us);
+// Versão do snapshot: muda a cada nova amostra
+uint32_t acq_version(const acq_t *acq, int source);
+void acq_get_stats(const acq_t *acq, int source, acq_source_stats_t *stats);
+
+void acq_load_begin(acq_load_t *load, uint32_t now_us);
+void acq_load_end(acq_load_t *load, uint32_t now_us);
+// Ocupação do core1 na última janela, em décimos de %
+uint16_t acq_core1_load(const acq_t *acq);
+
+#endif
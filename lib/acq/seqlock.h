@@ -0,0 +1,50 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Seqlock para um escritor e vários leitores (p.ex. core1 -> core0). O escritor
+// nunca espera: incrementa seq (ímpar = escrita em andamento), copia o dado e
+// incrementa de novo. O leitor copia o dado e confere se seq não mudou; se mudou,
+// copia de novo. A escrita protegida deve ser curta (só a cópia de um buffer
+// já pronto), assim o leitor praticamente nunca repete.
+
+typedef struct {
+    volatile uint32_t seq;
+} seqlock_t;
+
+static inline void seqlock_init(seqlock_t *s) {
+    s->seq = 0;
+}
+
+// ---- Escritor ----
+
+static inline void seqlock_write_begin(seqlock_t *s) {
+    __atomic_store_n(&s->seq, s->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void seqlock_write_end(seqlock_t *s) {
+    __atomic_store_n(&s->seq, s->seq + 1, __ATOMIC_RELEASE);
+}
+
+// ---- Leitor ----
+
+// Versão atual; se ímpar, a cópia que vier a seguir certamente será repetida
+static inline uint32_t seqlock_read_begin(const seqlock_t *s) {
+    return __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+}
+
+// true se a cópia feita desde seqlock_read_begin() não é consistente
+static inline bool seqlock_read_retry(const seqlock_t *s, uint32_t seq) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return (seq & 1) || __atomic_load_n(&s->seq, __ATOMIC_RELAXED) != seq;
+}
+
+// Quantas publicações completas já houve
+static inline uint32_t seqlock_version(const seqlock_t *s) {
+    return seqlock_read_begin(s) >> 1;
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Anel sem trava para um produtor e um consumidor (p.ex. IRQ -> loop principal,
+// ou core1 -> core0). head só é escrito pelo produtor e tail só pelo consumidor;
+// os contadores correm livres e a ocupação é head - tail. A capacidade é uma
+// potência de 2, então o índice é uma máscara.
+//
+// Anel cheio: o produtor descarta o elemento novo e conta em overruns (não pode
+// sobrescrever o mais antigo sem disputar o tail com o consumidor).
+
+typedef struct {
+    uint8_t *buf;
+    uint32_t elem_size;
+    uint32_t mask;              // capacidade - 1
+    volatile uint32_t head;     // total já publicado (produtor)
+    volatile uint32_t tail;     // total já consumido (consumidor)
+    volatile uint32_t overruns; // elementos descartados com o anel cheio (produtor)
+} spsc_ring_t;
+
+// buf deve ter capacity * elem_size bytes; capacity potência de 2
+static inline bool spsc_ring_init(spsc_ring_t *r, void *buf, uint32_t elem_size, uint32_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1))) return false;
+    r->buf = (uint8_t *)buf;
+    r->elem_size = elem_size;
+    r->mask = capacity - 1;
+    r->head = 0;
+    r->tail = 0;
+    r->overruns = 0;
+    return true;
+}
+
+static inline uint32_t spsc_ring_capacity(const spsc_ring_t *r) {
+    return r->mask + 1;
+}
+
+static inline uint32_t spsc_ring_count(const spsc_ring_t *r) {
+    return __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+}
+
+static inline uint32_t spsc_ring_free(const spsc_ring_t *r) {
+    return spsc_ring_capacity(r) - spsc_ring_count(r);
+}
+
+// ---- Produtor ----
+
+// Posição livre para escrever no lugar (sem cópia extra), ou NULL se cheio
+static inline void *spsc_ring_claim(spsc_ring_t *r) {
+    uint32_t head = r->head;
+    if (head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) > r->mask) return NULL;
+    return r->buf + (head & r->mask) * r->elem_size;
+}
+
+// Publica o elemento preenchido em spsc_ring_claim()
+static inline void spsc_ring_publish(spsc_ring_t *r) {
+    __atomic_store_n(&r->head, r->head + 1, __ATOMIC_RELEASE);
+}
+
+static inline bool spsc_ring_push(spsc_ring_t *r, const void *elem) {
+    void *slot = spsc_ring_claim(r);
+    if (!slot) {
+        r->overruns++;
+        return false;
+    }
+    memcpy(slot, elem, r->elem_size);
+    spsc_ring_publish(r);
+    return true;
+}
+
+// ---- Consumidor ----
+
+// Elemento mais antigo, lido no lugar, ou NULL se vazio. Libere com spsc_ring_release()
+static inline const void *spsc_ring_peek(const spsc_ring_t *r) {
+    uint32_t tail = r->tail;
+    if (__atomic_load_n(&r->head, __ATOMIC_ACQUIRE) == tail) return NULL;
+    return r->buf + (tail & r->mask) * r->elem_size;
+}
+
+static inline void spsc_ring_release(spsc_ring_t *r) {
+    __atomic_store_n(&r->tail, r->tail + 1, __ATOMIC_RELEASE);
+}
+
+static inline bool spsc_ring_pop(spsc_ring_t *r, void *elem) {
+    const void *slot = spsc_ring_peek(r);
+    if (!slot) return false;
+    memcpy(elem, slot, r->elem_size);
+    spsc_ring_release(r);
+    return true;
+}
+
+#endif
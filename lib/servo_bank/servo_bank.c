@@ -0,0 +1,111 @@
+#include "servo_bank.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+
+#define PULSE_NEUTRAL_US 1500.0f
+
+static servo_bank_t default_bank;
+static bool default_ready;
+
+void servo_bank_init(servo_bank_t *bank) {
+    bank->count = 0;
+    bank->slice_mask = 0;
+    bank->dirty_mask = 0;
+    bank->running = false;
+
+    // Menor divisor (em 1/16) com o período de 20 ms cabendo em 16 bits
+    uint64_t sys16 = (uint64_t)clock_get_hz(clk_sys) * 16;
+    uint64_t per_period = 1000000u / SERVO_BANK_PERIOD_US;   // 50 Hz
+    uint32_t div16 = (uint32_t)((sys16 + per_period * 65536 - 1) / (per_period * 65536));
+    if (div16 < 16) div16 = 16;
+    if (div16 > 0xFFF) div16 = 0xFFF;
+
+    bank->div_int = div16 >> 4;
+    bank->div_frac = div16 & 0xF;
+    bank->period_ticks = (uint32_t)(sys16 / (div16 * per_period));
+    if (bank->period_ticks > 65536) bank->period_ticks = 65536;
+
+    for (uint s = 0; s < NUM_PWM_SLICES; s++) {
+        bank->level[s][0] = 0;
+        bank->level[s][1] = 0;
+    }
+}
+
+servo_bank_t *servo_bank_default(void) {
+    if (!default_ready) {
+        servo_bank_init(&default_bank);
+        default_ready = true;
+    }
+    return &default_bank;
+}
+
+int servo_bank_add(servo_bank_t *bank, uint gpio) {
+    if (bank->count >= SERVO_BANK_MAX) return -1;
+
+    uint slice = pwm_gpio_to_slice_num(gpio);
+    uint chan = pwm_gpio_to_channel(gpio);
+    for (uint8_t i = 0; i < bank->count; i++) {
+        if (bank->slice[i] == slice && bank->chan[i] == chan) return -1;
+    }
+
+    if (!(bank->slice_mask & (1u << slice))) {
+        // Fatia nova: configurada parada; entra em fase no próximo start
+        pwm_set_enabled(slice, false);
+        pwm_set_clkdiv_int_frac(slice, bank->div_int, bank->div_frac);
+        pwm_set_wrap(slice, (uint16_t)(bank->period_ticks - 1));
+        pwm_set_both_levels(slice, 0, 0);
+        bank->slice_mask |= 1u << slice;
+    }
+
+    int ch = bank->count++;
+    bank->gpio[ch] = gpio;
+    bank->slice[ch] = slice;
+    bank->chan[ch] = chan;
+    gpio_set_function(gpio, GPIO_FUNC_PWM);
+
+    servo_bank_set_pulse(bank, ch, PULSE_NEUTRAL_US);
+    servo_bank_apply(bank);
+    return ch;
+}
+
+void servo_bank_start(servo_bank_t *bank) {
+    // Para tudo, zera os contadores e liga todas as fatias na mesma escrita
+    uint32_t irq = save_and_disable_interrupts();
+    pwm_set_mask_enabled(0);
+    for (uint s = 0; s < NUM_PWM_SLICES; s++) {
+        if (bank->slice_mask & (1u << s)) pwm_set_counter(s, 0);
+    }
+    pwm_set_mask_enabled(bank->slice_mask);
+    bank->running = true;
+    restore_interrupts(irq);
+}
+
+void servo_bank_stop(servo_bank_t *bank) {
+    for (uint s = 0; s < NUM_PWM_SLICES; s++) {
+        if (bank->slice_mask & (1u << s)) pwm_set_enabled(s, false);
+    }
+    bank->running = false;
+}
+
+void servo_bank_set_pulse(servo_bank_t *bank, int ch, float pulse_us) {
+    if (ch < 0 || ch >= bank->count) return;
+    if (pulse_us < 0) pulse_us = 0;
+    if (pulse_us > SERVO_BANK_PERIOD_US) pulse_us = SERVO_BANK_PERIOD_US;
+
+    float ticks = pulse_us * bank->period_ticks / SERVO_BANK_PERIOD_US + 0.5f;
+    uint16_t level = ticks >= 65535.0f ? 65535 : (uint16_t)ticks;
+    uint8_t slice = bank->slice[ch];
+    bank->level[slice][bank->chan[ch]] = level;
+    bank->dirty_mask |= 1u << slice;
+}
+
+void servo_bank_apply(servo_bank_t *bank) {
+    // Pode ser chamado do loop e de alarmes (servo_sim): cada fatia sai inteira
+    uint32_t irq = save_and_disable_interrupts();
+    uint8_t dirty = bank->dirty_mask;
+    bank->dirty_mask = 0;
+    for (uint s = 0; s < NUM_PWM_SLICES; s++) {
+        if (dirty & (1u << s)) pwm_set_both_levels(s, bank->level[s][0], bank->level[s][1]);
+    }
+    restore_interrupts(irq);
+}
@@ -0,0 +1,62 @@
+#ifndef SERVO_BANK_H
+#define SERVO_BANK_H
+
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+
+// Banco de servos: até 16 canais nas 8 fatias de PWM, todos a 50 Hz, com o
+// divisor calculado a partir de clock_get_hz(clk_sys) (funciona com qualquer
+// clock do sistema, não só 125 MHz). O divisor é o menor que cabe 20 ms em 16
+// bits, o que dá ~0,3 us de resolução a 125 MHz.
+//
+// As fatias do banco são iniciadas juntas (contadores zerados e um único
+// pwm_set_mask_enabled), então as bordas de subida ficam alinhadas. Os níveis
+// são preparados com servo_bank_set_pulse() e gravados de uma vez com
+// servo_bank_apply(); o PWM só os adota no fim do período, então todos os
+// servos mudam no mesmo quadro. As fatias usadas pelo banco são exclusivas dele.
+
+#define SERVO_BANK_MAX       16
+#define SERVO_BANK_PERIOD_US 20000
+
+typedef struct {
+    uint8_t count;
+    uint8_t gpio[SERVO_BANK_MAX];
+    uint8_t slice[SERVO_BANK_MAX];
+    uint8_t chan[SERVO_BANK_MAX];
+
+    uint32_t period_ticks;      // ticks do PWM em 20 ms (wrap + 1)
+    uint8_t div_int, div_frac;  // divisor 8.4
+    uint8_t slice_mask;         // fatias em uso
+    bool running;
+
+    // Níveis preparados por fatia [A, B] e fatias alteradas desde o último apply
+    uint16_t level[NUM_PWM_SLICES][2];
+    volatile uint8_t dirty_mask;
+} servo_bank_t;
+
+void servo_bank_init(servo_bank_t *bank);
+
+// Banco compartilhado pelas bibliotecas de servo (servo_sim, servo_velocity)
+servo_bank_t *servo_bank_default(void);
+
+// Aloca o canal do GPIO (pulso inicial de 1500 us). Retorna o índice do canal, ou
+// -1 se o banco estiver cheio ou o canal de PWM já estiver em uso.
+// Fatias novas só começam a rodar no próximo servo_bank_start()
+int servo_bank_add(servo_bank_t *bank, uint gpio);
+
+// (Re)inicia todas as fatias do banco em fase
+void servo_bank_start(servo_bank_t *bank);
+void servo_bank_stop(servo_bank_t *bank);
+
+// Prepara o pulso do canal (us); só vai para o PWM no servo_bank_apply()
+void servo_bank_set_pulse(servo_bank_t *bank, int ch, float pulse_us);
+// Grava os níveis preparados: uma escrita por fatia alterada (os dois canais juntos)
+void servo_bank_apply(servo_bank_t *bank);
+
+// set_pulse + apply, para quem comanda um servo só
+static inline void servo_bank_write(servo_bank_t *bank, int ch, float pulse_us) {
+    servo_bank_set_pulse(bank, ch, pulse_us);
+    servo_bank_apply(bank);
+}
+
+#endif
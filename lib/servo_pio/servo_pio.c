@@ -0,0 +1,87 @@
+#include "servo_pio.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "servo_pio.pio.h"
+
+// Instruções fixas em cada trecho da janela: alto = x + 3 ciclos, baixo = y + 4
+#define SERVO_PIO_HIGH_CYCLES 3
+#define SERVO_PIO_LOW_CYCLES  4
+#define PULSE_NEUTRAL_US      1500
+
+// Programa carregado uma vez por bloco PIO (offset, ou -1)
+static int program_offset[2] = { -1, -1 };
+
+static uint32_t slot_word(uint8_t mask, uint32_t high_us) {
+    if (high_us < SERVO_PIO_HIGH_CYCLES) high_us = SERVO_PIO_HIGH_CYCLES;
+    if (high_us > SERVO_PIO_SLOT_US - SERVO_PIO_LOW_CYCLES) high_us = SERVO_PIO_SLOT_US - SERVO_PIO_LOW_CYCLES;
+    uint32_t low_us = SERVO_PIO_SLOT_US - high_us;
+
+    return mask
+         | (high_us - SERVO_PIO_HIGH_CYCLES) << 8
+         | (low_us - SERVO_PIO_LOW_CYCLES) << 20;
+}
+
+bool servo_pio_init(servo_pio_t *sp, PIO pio, uint pin_base, uint count) {
+    if (count == 0 || count > SERVO_PIO_SLOTS) return false;
+
+    uint idx = pio_get_index(pio);
+    if (program_offset[idx] < 0) {
+        if (!pio_can_add_program(pio, &servo_pio_program)) return false;
+        program_offset[idx] = pio_add_program(pio, &servo_pio_program);
+    }
+    int sm = pio_claim_unused_sm(pio, false);
+    if (sm < 0) return false;
+
+    sp->dma_data = dma_claim_unused_channel(false);
+    sp->dma_ctrl = dma_claim_unused_channel(false);
+    if (sp->dma_data < 0 || sp->dma_ctrl < 0) {
+        if (sp->dma_data >= 0) dma_channel_unclaim(sp->dma_data);
+        if (sp->dma_ctrl >= 0) dma_channel_unclaim(sp->dma_ctrl);
+        pio_sm_unclaim(pio, sm);
+        return false;
+    }
+
+    sp->pio = pio;
+    sp->sm = sm;
+    sp->pin_base = pin_base;
+    sp->count = count;
+    for (uint i = 0; i < SERVO_PIO_SLOTS; i++) sp->frame[i] = slot_word(0, PULSE_NEUTRAL_US);
+    sp->frame_addr = sp->frame;
+
+    // 1 ciclo = 1 us com qualquer clock do sistema
+    float clkdiv = clock_get_hz(clk_sys) / 1000000.0f;
+    servo_pio_program_init(pio, sm, program_offset[idx], pin_base, count, clkdiv);
+
+    // Dados: quadro inteiro para o FIFO, no ritmo da SM; ao terminar chama o controle
+    dma_channel_config c = dma_channel_get_default_config(sp->dma_data);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(pio, sm, true));
+    channel_config_set_chain_to(&c, sp->dma_ctrl);
+    dma_channel_configure(sp->dma_data, &c, &pio->txf[sm], sp->frame, SERVO_PIO_SLOTS, false);
+
+    // Controle: regrava o endereço de leitura dos dados (registrador com disparo),
+    // reiniciando o quadro
+    dma_channel_config k = dma_channel_get_default_config(sp->dma_ctrl);
+    channel_config_set_transfer_data_size(&k, DMA_SIZE_32);
+    channel_config_set_read_increment(&k, false);
+    channel_config_set_write_increment(&k, false);
+    dma_channel_configure(sp->dma_ctrl, &k, &dma_hw->ch[sp->dma_data].al3_read_addr_trig,
+                          &sp->frame_addr, 1, false);
+
+    pio_sm_set_enabled(pio, sm, true);
+    dma_channel_start(sp->dma_ctrl);
+    return true;
+}
+
+void servo_pio_set_pulse(servo_pio_t *sp, int ch, float pulse_us) {
+    if (ch < 0 || ch >= sp->count) return;
+
+    // Escrita de 32 bits: o DMA nunca lê meia palavra
+    if (pulse_us <= 0) {
+        sp->frame[ch] = slot_word(0, PULSE_NEUTRAL_US);
+    } else {
+        sp->frame[ch] = slot_word(1u << ch, (uint32_t)(pulse_us + 0.5f));
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef SERVO_PIO_H
+#define SERVO_PIO_H
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+// Gerador de pulsos de servo por PIO: até 8 servos em pinos consecutivos por
+// máquina de estado, 50 Hz com resolução de 1 us, sem usar fatias de PWM.
+// Cada pino tem uma janela de 2500 us do quadro de 20 ms. Os pulsos ficam num
+// quadro em RAM que dois canais de DMA enviam ao FIFO em ciclo (um copia o
+// quadro, o outro o reinicia), então a CPU não faz nada por pulso: mudar um
+// servo é escrever uma palavra, que vale a partir da próxima janela dele.
+
+#define SERVO_PIO_SLOTS    8
+#define SERVO_PIO_SLOT_US  2500    // 8 x 2500 us = 20 ms
+
+typedef struct {
+    PIO pio;
+    uint sm;
+    uint pin_base;
+    uint8_t count;
+    int dma_data, dma_ctrl;
+
+    uint32_t frame[SERVO_PIO_SLOTS];  // uma palavra por janela (ver servo_pio.pio)
+    const uint32_t *frame_addr;       // lido pelo canal de controle do DMA
+} servo_pio_t;
+
+// Usa os pinos pin_base..pin_base+count-1 (count <= 8), uma SM livre de pio e
+// dois canais de DMA. Os pinos começam sem pulso. Retorna false se faltar recurso
+bool servo_pio_init(servo_pio_t *sp, PIO pio, uint pin_base, uint count);
+
+// Canal do GPIO, ou -1 se não for deste gerador
+static inline int servo_pio_channel(const servo_pio_t *sp, uint gpio) {
+    return gpio >= sp->pin_base && gpio < sp->pin_base + sp->count ? (int)(gpio - sp->pin_base) : -1;
+}
+
+// Pulso do canal em us (saturado dentro da janela); 0 desliga o pulso
+void servo_pio_set_pulse(servo_pio_t *sp, int ch, float pulse_us);
+
+#endif
@@ -0,0 +1,453 @@
+
+#include "ssd1306.h"
+#include <string.h>
+#include "font6x8.h"
+
+// Índices constantes em tempo de compilação (SSD1306_WIDTH é potência de 2)
+#define ROW(buf, page)    (&(buf)[SSD1306_WIDTH * (page)])
+#define BACK_PIXELS(dev)  (&(dev)->back[1])
+
+static bool ssd1306_write(ssd1306_t *dev, const uint8_t *buf, size_t len) {
+    dev->stats.bytes += len;
+    dev->stats.transactions++;
+    if (dev->transport.write(dev->transport.ctx, dev->addr, buf, len) >= 0) return true;
+    dev->stats.errors++;
+    return false;
+}
+
+static inline void mark_dirty(ssd1306_t *dev, uint8_t page, uint8_t x0, uint8_t x1) {
+    if (x0 < dev->dirty_x0[page]) dev->dirty_x0[page] = x0;
+    if (x1 > dev->dirty_x1[page]) dev->dirty_x1[page] = x1;
+}
+
+static inline void mark_clean(ssd1306_t *dev, uint8_t page) {
+    dev->dirty_x0[page] = 0xFF;
+    dev->dirty_x1[page] = 0;
+}
+
+void ssd1306_init_transport(ssd1306_t *dev, const ssd1306_transport_t *t, uint8_t addr) {
+    memset(dev, 0, sizeof(*dev));
+    dev->transport = *t;
+    dev->addr = addr;
+    dev->back[0] = 0x40;
+
+    // Sequência de inicialização enviada como um único fluxo de comandos
+    static const uint8_t init_cmds[] = {
+        0x00,                       // byte de controle: comandos
+        0xAE,                       // display off
+        0xA8, SSD1306_HEIGHT - 1,   // multiplex
+        0xD3, 0x00,                 // offset vertical
+        0x40,                       // linha inicial 0
+        0xA1,                       // remap de segmentos
+        0xC8,                       // varredura COM invertida
+        0xDA, SSD1306_COM_PINS,     // pinos COM
+        0x81, 0x7F,                 // contraste
+        0xA4,                       // exibe conteúdo da RAM
+        0xA6,                       // modo normal (não invertido)
+        0xD5, 0x80,                 // clock
+        0x8D, 0x14,                 // charge pump
+        0x20, 0x00,                 // endereçamento horizontal
+        0xAF                        // display on
+    };
+    ssd1306_write(dev, init_cmds, sizeof(init_cmds));
+    dev->display_on = true;
+    dev->contrast = 0x7F;
+
+    // Conteúdo da GDDRAM é indefinido após o reset
+    ssd1306_invalidate(dev);
+    ssd1306_show(dev);
+}
+
+void ssd1306_invalidate(ssd1306_t *dev) {
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        dev->dirty_x0[page] = 0;
+        dev->dirty_x1[page] = SSD1306_WIDTH - 1;
+    }
+    dev->force_pages = 0xFF;
+}
+
+void ssd1306_clear(ssd1306_t *dev) {
+    // Marca como suja apenas a faixa de cada página que tinha algo aceso
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        uint8_t *row = ROW(dev->buffer, page);
+        int first = 0, last = SSD1306_WIDTH - 1;
+        while (first < SSD1306_WIDTH && row[first] == 0) first++;
+        if (first == SSD1306_WIDTH) continue;
+        while (row[last] == 0) last--;
+        mark_dirty(dev, page, first, last);
+        memset(&row[first], 0, last - first + 1);
+    }
+}
+
+// Custo aproximado em bytes no barramento (endereço + controle + carga) de uma janela
+static uint32_t window_cost(const ssd1306_window_t *w) {
+    uint32_t width = w->c1 - w->c0 + 1;
+    uint32_t rows = w->p1 - w->p0 + 1;
+    uint32_t cost = 1 + 7;
+
+    if (width == SSD1306_WIDTH) return cost + 2 + width * rows;
+    return cost + rows * (2 + width);
+}
+
+// Copia para o back apenas os bytes alterados e agrupa as faixas em janelas,
+// juntando páginas vizinhas quando uma janela maior custa menos que duas separadas
+static uint8_t ssd1306_snapshot(ssd1306_t *dev) {
+    bool barrier = false;
+    dev->win_count = 0;
+
+    if (dev->flush_failed) {
+        dev->flush_failed = false;
+        ssd1306_invalidate(dev);
+    }
+
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        int x0 = dev->dirty_x0[page];
+        int x1 = dev->dirty_x1[page];
+
+        // Página em rolagem: continua suja e nenhuma janela pode atravessá-la
+        if (dev->scroll_pages & (1u << page)) {
+            barrier = true;
+            continue;
+        }
+        if (x0 > x1) continue;
+
+        uint8_t *row = ROW(dev->buffer, page);
+        uint8_t *old = ROW(BACK_PIXELS(dev), page);
+
+        // Reduz a faixa aos bytes que realmente diferem da GDDRAM
+        if (!(dev->force_pages & (1u << page))) {
+            while (x0 <= x1 && row[x0] == old[x0]) x0++;
+            while (x1 >= x0 && row[x1] == old[x1]) x1--;
+        }
+        mark_clean(dev, page);
+        if (x0 > x1) continue;
+
+        memcpy(&old[x0], &row[x0], x1 - x0 + 1);
+
+        ssd1306_window_t span = { (uint8_t)x0, (uint8_t)x1, page, page };
+        if (dev->win_count > 0 && !barrier) {
+            ssd1306_window_t *last = &dev->windows[dev->win_count - 1];
+            ssd1306_window_t merged = {
+                last->c0 < span.c0 ? last->c0 : span.c0,
+                last->c1 > span.c1 ? last->c1 : span.c1,
+                last->p0,
+                page
+            };
+            if (window_cost(&merged) <= window_cost(last) + window_cost(&span)) {
+                *last = merged;
+                continue;
+            }
+        }
+        dev->windows[dev->win_count++] = span;
+        barrier = false;
+    }
+
+    dev->force_pages &= dev->scroll_pages;
+    return dev->win_count;
+}
+
+// Monta o próximo segmento da janela atual: primeiro os comandos de janela
+// (0x21/0x22), depois os dados. Com endereçamento horizontal, uma janela de
+// largura total é contígua no back e sai em uma única transação; janelas
+// mais estreitas saem uma linha de página por transação, sem reendereçar.
+// Os dados saem direto do back: o byte anterior é trocado temporariamente
+// pelo byte de controle 0x40 e restaurado em segment_end()
+static const uint8_t *segment_begin(ssd1306_t *dev, size_t *len) {
+    const ssd1306_window_t *w = &dev->windows[dev->win_index];
+
+    if (dev->win_row < 0) {
+        uint8_t *cmd = dev->win_cmd;
+        cmd[0] = 0x00;
+        cmd[1] = 0x21; cmd[2] = SSD1306_COL_OFFSET + w->c0; cmd[3] = SSD1306_COL_OFFSET + w->c1;
+        cmd[4] = 0x22; cmd[5] = w->p0; cmd[6] = w->p1;
+        *len = sizeof(dev->win_cmd);
+        return cmd;
+    }
+
+    uint8_t page = w->p0 + dev->win_row;
+    size_t width = w->c1 - w->c0 + 1;
+    if (width == SSD1306_WIDTH) width *= w->p1 - w->p0 + 1;
+
+    dev->win_ctrl = &ROW(dev->back, page)[w->c0];
+    dev->win_saved = *dev->win_ctrl;
+    *dev->win_ctrl = 0x40;
+    *len = width + 1;
+    return dev->win_ctrl;
+}
+
+static void segment_end(ssd1306_t *dev) {
+    const ssd1306_window_t *w = &dev->windows[dev->win_index];
+
+    if (dev->win_row >= 0) {
+        *dev->win_ctrl = dev->win_saved;
+    }
+    dev->win_row++;
+    if (dev->win_row > w->p1 - w->p0 ||
+        (dev->win_row > 0 && w->c1 - w->c0 + 1 == SSD1306_WIDTH)) {
+        dev->win_index++;
+        dev->win_row = -1;
+    }
+}
+
+static void flush_step(void *arg, bool ok);
+
+// A GDDRAM ficou num estado desconhecido: desiste do resto do envio e reenvia
+// o quadro inteiro na próxima vez (invalidado fora da IRQ, no snapshot)
+static void flush_abort(ssd1306_t *dev) {
+    if (dev->win_row >= 0) *dev->win_ctrl = dev->win_saved;
+    dev->win_index = dev->win_count;
+    dev->flush_failed = true;
+}
+
+static void flush_finish(ssd1306_t *dev) {
+    dev->flush_busy = false;
+    if (dev->flush_done) dev->flush_done(dev->flush_arg);
+}
+
+static void flush_next(ssd1306_t *dev) {
+    while (dev->win_index < dev->win_count) {
+        size_t len;
+        const uint8_t *data = segment_begin(dev, &len);
+
+        if (dev->transport.write_async &&
+            dev->transport.write_async(dev->transport.ctx, dev->addr, data, len, flush_step, dev)) {
+            dev->stats.bytes += len;
+            dev->stats.transactions++;
+            return;
+        }
+        if (!ssd1306_write(dev, data, len)) {
+            flush_abort(dev);
+            flush_finish(dev);
+            return;
+        }
+        segment_end(dev);
+    }
+
+    dev->stats.flushes++;
+    flush_finish(dev);
+}
+
+static void flush_step(void *arg, bool ok) {
+    ssd1306_t *dev = (ssd1306_t *)arg;
+    if (!ok) {
+        dev->stats.errors++;
+        flush_abort(dev);
+        flush_finish(dev);
+        return;
+    }
+    segment_end(dev);
+    flush_next(dev);
+}
+
+bool ssd1306_show_async(ssd1306_t *dev, ssd1306_done_cb_t done, void *arg) {
+    if (dev->flush_busy) return false;
+
+    if (!ssd1306_snapshot(dev)) {
+        if (done) done(arg);
+        return true;
+    }
+
+    dev->flush_done = done;
+    dev->flush_arg = arg;
+    dev->win_index = 0;
+    dev->win_row = -1;
+    dev->flush_busy = true;
+    flush_next(dev);
+    return true;
+}
+
+bool ssd1306_flush_busy(const ssd1306_t *dev) {
+    return dev->flush_busy;
+}
+
+bool ssd1306_flush_wait(ssd1306_t *dev) {
+    bool ok = true;
+    while (dev->flush_busy) {
+        // Sem wait() o transporte não é assíncrono e nada fica pendente
+        if (!dev->transport.wait) break;
+        if (!dev->transport.wait(dev->transport.ctx, SSD1306_WAIT_TIMEOUT_US)) ok = false;
+    }
+    return ok;
+}
+
+bool ssd1306_pending(const ssd1306_t *dev) {
+    if (dev->flush_failed) return true;
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        if (dev->scroll_pages & (1u << page)) continue;
+        if (dev->dirty_x0[page] <= dev->dirty_x1[page]) return true;
+    }
+    return false;
+}
+
+static void flush_blocking(ssd1306_t *dev) {
+    for (dev->win_index = 0, dev->win_row = -1; dev->win_index < dev->win_count; ) {
+        size_t len;
+        const uint8_t *data = segment_begin(dev, &len);
+        if (!ssd1306_write(dev, data, len)) {
+            flush_abort(dev);   // mesmo tratamento do envio assíncrono
+            return;
+        }
+        segment_end(dev);
+    }
+    dev->stats.flushes++;
+}
+
+void ssd1306_show(ssd1306_t *dev) {
+    ssd1306_flush_wait(dev);   // aguarda o envio assíncrono anterior
+    if (!ssd1306_snapshot(dev)) return;
+    flush_blocking(dev);
+}
+
+void ssd1306_show_window(ssd1306_t *dev, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1) {
+    if (x1 >= SSD1306_WIDTH) x1 = SSD1306_WIDTH - 1;
+    if (page1 >= SSD1306_PAGES) page1 = SSD1306_PAGES - 1;
+    if (x0 > x1 || page0 > page1) return;
+
+    ssd1306_flush_wait(dev);   // aguarda o envio assíncrono anterior
+    for (uint8_t page = page0; page <= page1; page++) {
+        memcpy(&ROW(BACK_PIXELS(dev), page)[x0], &ROW(dev->buffer, page)[x0], x1 - x0 + 1);
+    }
+    dev->windows[0] = (ssd1306_window_t){ x0, x1, page0, page1 };
+    dev->win_count = 1;
+    flush_blocking(dev);
+}
+
+// Comandos avulsos só saem com o barramento livre, fora de um envio assíncrono
+static void send_commands(ssd1306_t *dev, const uint8_t *cmds, size_t len) {
+    ssd1306_flush_wait(dev);   // aguarda o envio assíncrono anterior
+    ssd1306_write(dev, cmds, len);
+}
+
+void ssd1306_set_display_on(ssd1306_t *dev, bool on) {
+    if (dev->display_on == on) return;
+    uint8_t cmd[] = { 0x00, on ? 0xAF : 0xAE };
+    send_commands(dev, cmd, sizeof(cmd));
+    dev->display_on = on;
+}
+
+void ssd1306_set_invert(ssd1306_t *dev, bool invert) {
+    if (dev->inverted == invert) return;
+    uint8_t cmd[] = { 0x00, invert ? 0xA7 : 0xA6 };
+    send_commands(dev, cmd, sizeof(cmd));
+    dev->inverted = invert;
+}
+
+void ssd1306_set_contrast(ssd1306_t *dev, uint8_t contrast) {
+    if (dev->contrast == contrast) return;
+    uint8_t cmd[] = { 0x00, 0x81, contrast };
+    send_commands(dev, cmd, sizeof(cmd));
+    dev->contrast = contrast;
+}
+
+void ssd1306_scroll_start(ssd1306_t *dev, ssd1306_scroll_dir_t dir, uint8_t page0, uint8_t page1,
+                          ssd1306_scroll_speed_t speed) {
+    if (page1 >= SSD1306_PAGES) page1 = SSD1306_PAGES - 1;
+    if (page0 > page1) return;
+
+    // Uma rolagem anterior precisa parar (e ter suas páginas restauradas) antes
+    ssd1306_scroll_stop(dev);
+    ssd1306_show(dev);
+
+    uint8_t cmd[] = {
+        0x00,
+        (uint8_t)dir, 0x00, page0, (uint8_t)speed, page1, 0x00, 0xFF,
+        0x2F                        // ativa a rolagem
+    };
+    send_commands(dev, cmd, sizeof(cmd));
+    dev->scroll_pages = (uint8_t)((0xFFu >> (7 - page1)) & (0xFFu << page0));
+}
+
+void ssd1306_scroll_stop(ssd1306_t *dev) {
+    if (!dev->scroll_pages) return;
+
+    static const uint8_t cmd[] = { 0x00, 0x2E };
+    send_commands(dev, cmd, sizeof(cmd));
+
+    // A GDDRAM das páginas roladas ficou deslocada: reenvia-as por inteiro
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        if (dev->scroll_pages & (1u << page)) mark_dirty(dev, page, 0, SSD1306_WIDTH - 1);
+    }
+    dev->force_pages |= dev->scroll_pages;
+    dev->scroll_pages = 0;
+}
+
+void ssd1306_draw_pixel(ssd1306_t *dev, uint8_t x, uint8_t y, bool color) {
+    if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) return;
+    uint8_t *byte = &ROW(dev->buffer, y >> 3)[x];
+    uint8_t bit = 1u << (y & 7);
+    uint8_t value = color ? (*byte | bit) : (*byte & ~bit);
+    if (value == *byte) return;
+    *byte = value;
+    mark_dirty(dev, y >> 3, x, x);
+}
+
+void ssd1306_draw_vline(ssd1306_t *dev, uint8_t x, uint8_t y0, uint8_t y1, bool color) {
+    if (y0 > y1) { uint8_t t = y0; y0 = y1; y1 = t; }
+    if (x >= SSD1306_WIDTH || y0 >= SSD1306_HEIGHT) return;
+    if (y1 >= SSD1306_HEIGHT) y1 = SSD1306_HEIGHT - 1;
+
+    for (uint8_t page = y0 >> 3; page <= y1 >> 3; page++) {
+        uint8_t top = page == y0 >> 3 ? (y0 & 7) : 0;
+        uint8_t bottom = page == y1 >> 3 ? (y1 & 7) : 7;
+        uint8_t mask = (uint8_t)((0xFF << top) & (0xFF >> (7 - bottom)));
+        uint8_t *byte = &ROW(dev->buffer, page)[x];
+        uint8_t value = color ? (*byte | mask) : (*byte & ~mask);
+        if (value == *byte) continue;
+        *byte = value;
+        mark_dirty(dev, page, x, x);
+    }
+}
+
+// Escreve colunas inteiras do glifo direto nas páginas do buffer.
+// y múltiplo de 8: cópia direta em uma página; caso contrário o glifo é
+// deslocado e combinado (máscara AND/OR) em duas páginas consecutivas.
+// O recorte é calculado uma vez por string, não por pixel.
+void ssd1306_draw_string(ssd1306_t *dev, uint8_t x, uint8_t y, const char *text) {
+    if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) return;
+
+    uint8_t page = y >> 3;
+    uint8_t shift = y & 7;
+    uint8_t *row0 = ROW(dev->buffer, page);
+    uint8_t *row1 = (shift && page + 1 < SSD1306_PAGES) ? row0 + SSD1306_WIDTH : NULL;
+    uint8_t keep0 = (uint8_t)~(0xFF << shift);
+    uint8_t keep1 = (uint8_t)(0xFF << shift);
+
+    int lo0 = SSD1306_WIDTH, hi0 = -1;
+    int lo1 = SSD1306_WIDTH, hi1 = -1;
+
+    for (; *text && x < SSD1306_WIDTH; text++, x += 6) {
+        char c = *text;
+        if (c < 32 || c > 126) c = '?';
+        const uint8_t *glyph = &font6x8[(c - 32) * 5];
+        uint8_t cols = SSD1306_WIDTH - x < 5 ? SSD1306_WIDTH - x : 5;
+
+        for (uint8_t i = 0; i < cols; i++) {
+            uint8_t col = x + i;
+            uint8_t v0 = (row0[col] & keep0) | (uint8_t)(glyph[i] << shift);
+            if (v0 != row0[col]) {
+                row0[col] = v0;
+                if (col < lo0) lo0 = col;
+                hi0 = col;
+            }
+            if (row1) {
+                uint8_t v1 = (row1[col] & keep1) | (glyph[i] >> (8 - shift));
+                if (v1 != row1[col]) {
+                    row1[col] = v1;
+                    if (col < lo1) lo1 = col;
+                    hi1 = col;
+                }
+            }
+        }
+    }
+
+    if (hi0 >= 0) mark_dirty(dev, page, lo0, hi0);
+    if (hi1 >= 0) mark_dirty(dev, page + 1, lo1, hi1);
+}
+
+void ssd1306_get_stats(const ssd1306_t *dev, ssd1306_stats_t *out) {
+    *out = dev->stats;
+}
+
+void ssd1306_reset_stats(ssd1306_t *dev) {
+    memset(&dev->stats, 0, sizeof(dev->stats));
+}
@@ -0,0 +1,181 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SSD1306_I2C_ADDR     0x3C
+#define SSD1306_I2C_ADDR_ALT 0x3D
+
+// Geometria definida em tempo de compilação (p.ex. target_compile_definitions
+// com SSD1306_WIDTH=128 SSD1306_HEIGHT=32). O framebuffer tem exatamente o
+// tamanho do painel e toda a aritmética de índice vira constante.
+#ifndef SSD1306_WIDTH
+#define SSD1306_WIDTH    128
+#endif
+#ifndef SSD1306_HEIGHT
+#define SSD1306_HEIGHT   64
+#endif
+
+#if SSD1306_WIDTH == 128 && SSD1306_HEIGHT == 64
+#define SSD1306_COM_PINS   0x12
+#define SSD1306_COL_OFFSET 0
+#elif SSD1306_WIDTH == 128 && SSD1306_HEIGHT == 32
+#define SSD1306_COM_PINS   0x02
+#define SSD1306_COL_OFFSET 0
+#elif SSD1306_WIDTH == 64 && SSD1306_HEIGHT == 48
+#define SSD1306_COM_PINS   0x12
+#define SSD1306_COL_OFFSET 32   // painéis 64x48 usam as colunas 32..95 da GDDRAM
+#else
+#error "Geometria SSD1306 nao suportada (use 128x64, 128x32 ou 64x48)"
+#endif
+
+#define SSD1306_PAGES    (SSD1306_HEIGHT / 8)
+#define SSD1306_BUF_SIZE (SSD1306_WIDTH * SSD1306_PAGES)
+
+// Contadores de tráfego I2C efetivamente enviado ao display
+typedef struct {
+    uint32_t bytes;         // bytes escritos no barramento (inclui bytes de controle)
+    uint32_t transactions;  // transações I2C (START..STOP)
+    uint32_t flushes;       // chamadas a ssd1306_show() que enviaram algo
+    uint32_t errors;        // transações com erro (NACK, abort, timeout)
+} ssd1306_stats_t;
+
+typedef void (*ssd1306_done_cb_t)(void *arg);
+// Fim de uma transação assíncrona do transporte; ok = false em NACK/abort/timeout
+typedef void (*ssd1306_xfer_cb_t)(void *arg, bool ok);
+
+// Limite de espera por uma transação assíncrona em andamento
+#define SSD1306_WAIT_TIMEOUT_US 200000
+
+// Transporte do display: permite trocar o backend (I2C+DMA do RP2040, simulador no host...)
+typedef struct {
+    // Envia uma transação completa (START, endereço, dados, STOP) e só retorna ao final
+    int (*write)(void *ctx, uint8_t addr, const uint8_t *data, size_t len);
+    // Inicia o envio e retorna imediatamente; done(arg, ok) é chamado (possivelmente em
+    // IRQ) quando a transação terminou no barramento, ou falhou.
+    // Opcional: se NULL ou retornar false usa write()
+    bool (*write_async)(void *ctx, uint8_t addr, const uint8_t *data, size_t len,
+                        ssd1306_xfer_cb_t done, void *arg);
+    // Espera a transação assíncrona em andamento por até timeout_us; estourando,
+    // aborta (done com ok = false) e retorna false. Obrigatório com write_async
+    bool (*wait)(void *ctx, uint32_t timeout_us);
+    void *ctx;
+} ssd1306_transport_t;
+
+// Janela (colunas c0..c1, páginas p0..p1) de um envio
+typedef struct {
+    uint8_t c0;
+    uint8_t c1;
+    uint8_t p0;
+    uint8_t p1;
+} ssd1306_window_t;
+
+// Estado de um painel. Vários painéis podem coexistir (i2c0/i2c1, 0x3C/0x3D)
+typedef struct ssd1306 {
+    ssd1306_transport_t transport;
+    uint8_t addr;
+
+    // Buffer de desenho (front)
+    uint8_t buffer[SSD1306_BUF_SIZE];
+    // Buffer de envio (back): espelho da GDDRAM e origem das transferências.
+    // back[0] fica reservado para o byte de controle 0x40; os pixels começam em back[1]
+    uint8_t back[1 + SSD1306_BUF_SIZE];
+
+    // Faixa de colunas suja por página; x0 > x1 indica página limpa
+    uint8_t dirty_x0[SSD1306_PAGES];
+    uint8_t dirty_x1[SSD1306_PAGES];
+    uint8_t force_pages;     // bit por página: reenviar sem comparar com o back
+
+    // Estado dos efeitos do controlador (evita reenviar comandos repetidos)
+    bool display_on;
+    bool inverted;
+    uint8_t contrast;
+    uint8_t scroll_pages;    // bit por página em rolagem: não recebe dados até parar
+
+    // Janelas congeladas no back para o envio em andamento
+    ssd1306_window_t windows[SSD1306_PAGES];
+    uint8_t win_count;
+    uint8_t win_index;
+    int8_t win_row;          // -1: comandos da janela; >= 0: linha de dados
+    uint8_t win_cmd[7];
+    uint8_t *win_ctrl;
+    uint8_t win_saved;
+    volatile bool flush_busy;
+    volatile bool flush_failed;  // envio com erro: o próximo reenvia o quadro inteiro
+    ssd1306_done_cb_t flush_done;
+    void *flush_arg;
+
+    ssd1306_stats_t stats;
+} ssd1306_t;
+
+struct i2c_inst;
+
+// Inicializa usando o backend I2C (com DMA) do RP2040
+void ssd1306_init(ssd1306_t *dev, struct i2c_inst *i2c, uint8_t addr);
+// Inicializa usando um transporte qualquer
+void ssd1306_init_transport(ssd1306_t *dev, const ssd1306_transport_t *transport, uint8_t addr);
+
+void ssd1306_clear(ssd1306_t *dev);
+void ssd1306_show(ssd1306_t *dev);
+void ssd1306_draw_string(ssd1306_t *dev, uint8_t x, uint8_t y, const char *text);
+void ssd1306_draw_pixel(ssd1306_t *dev, uint8_t x, uint8_t y, bool color);
+// Linha vertical y0..y1 (inclusive) na coluna x, escrita como máscara por página
+void ssd1306_draw_vline(ssd1306_t *dev, uint8_t x, uint8_t y0, uint8_t y1, bool color);
+
+// Envia incondicionalmente a janela retangular (colunas x0..x1, páginas page0..page1).
+// Janelas de largura total saem em uma única transação I2C
+void ssd1306_show_window(ssd1306_t *dev, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1);
+
+// Congela as alterações pendentes num buffer de envio e retorna sem esperar o barramento.
+// O desenho pode continuar normalmente enquanto o envio ocorre. Retorna false (sem enviar)
+// se um envio anterior ainda estiver em andamento; done é chamado em contexto de IRQ.
+// Se uma transação falhar, o envio termina (done é chamado) e o quadro inteiro é
+// reenviado no próximo ssd1306_show()
+bool ssd1306_show_async(ssd1306_t *dev, ssd1306_done_cb_t done, void *arg);
+bool ssd1306_flush_busy(const ssd1306_t *dev);
+// Espera o envio assíncrono terminar; cada transação tem até SSD1306_WAIT_TIMEOUT_US.
+// Retorna false se alguma foi abortada por timeout
+bool ssd1306_flush_wait(ssd1306_t *dev);
+// Há alterações a enviar (fora das páginas em rolagem)?
+bool ssd1306_pending(const ssd1306_t *dev);
+
+// Força o reenvio do quadro inteiro no próximo ssd1306_show()
+void ssd1306_invalidate(ssd1306_t *dev);
+
+// Efeitos executados pelo próprio controlador: cada chamada custa uma transação
+// de 2 a 10 bytes, sem tocar na GDDRAM. Chamadas que não mudam o estado não enviam nada.
+void ssd1306_set_display_on(ssd1306_t *dev, bool on);    // 0xAF / 0xAE (RAM preservada)
+void ssd1306_set_invert(ssd1306_t *dev, bool invert);    // 0xA7 / 0xA6
+void ssd1306_set_contrast(ssd1306_t *dev, uint8_t contrast);  // 0x81
+
+typedef enum {
+    SSD1306_SCROLL_RIGHT = 0x26,
+    SSD1306_SCROLL_LEFT  = 0x27
+} ssd1306_scroll_dir_t;
+
+// Intervalo entre passos de 1 coluna, em quadros do display (código do datasheet)
+typedef enum {
+    SSD1306_SCROLL_2_FRAMES   = 0x07,
+    SSD1306_SCROLL_3_FRAMES   = 0x04,
+    SSD1306_SCROLL_4_FRAMES   = 0x05,
+    SSD1306_SCROLL_5_FRAMES   = 0x00,
+    SSD1306_SCROLL_25_FRAMES  = 0x06,
+    SSD1306_SCROLL_64_FRAMES  = 0x01,
+    SSD1306_SCROLL_128_FRAMES = 0x02,
+    SSD1306_SCROLL_256_FRAMES = 0x03
+} ssd1306_scroll_speed_t;
+
+// Rolagem horizontal contínua (letreiro) das páginas page0..page1. Envia antes as
+// alterações pendentes. A GDDRAM não pode ser escrita durante a rolagem: as páginas
+// roladas ficam sujas e só são enviadas depois de ssd1306_scroll_stop(), que as
+// reenvia por inteiro no próximo ssd1306_show(). As demais páginas seguem normais.
+void ssd1306_scroll_start(ssd1306_t *dev, ssd1306_scroll_dir_t dir, uint8_t page0, uint8_t page1,
+                          ssd1306_scroll_speed_t speed);
+void ssd1306_scroll_stop(ssd1306_t *dev);
+
+void ssd1306_get_stats(const ssd1306_t *dev, ssd1306_stats_t *stats);
+void ssd1306_reset_stats(ssd1306_t *dev);
+
+#endif
@@ -0,0 +1,227 @@
+#include "ssd1306_emu.h"
+#include <string.h>
+
+void ssd1306_emu_init(ssd1306_emu_t *emu, uint8_t addr) {
+    memset(emu, 0, sizeof(*emu));
+    emu->addr = addr;
+    emu->mode = 2;                   // valores de reset do datasheet
+    emu->col_end = 127;
+    emu->page_end = 7;
+    emu->contrast = 0x7F;
+}
+
+void ssd1306_emu_reset_counters(ssd1306_emu_t *emu) {
+    emu->bytes = 0;
+    emu->transactions = 0;
+    emu->commands = 0;
+    emu->data_bytes = 0;
+    emu->ram_writes_into_scroll = 0;
+    emu->bus_bits = 0;
+}
+
+uint32_t ssd1306_emu_bus_time_us(const ssd1306_emu_t *emu, uint32_t scl_hz) {
+    return (uint32_t)((emu->bus_bits * 1000000u + scl_hz - 1) / scl_hz);
+}
+
+// Avança o ponteiro da GDDRAM após um byte de dados, conforme o modo
+static void advance(ssd1306_emu_t *emu) {
+    switch (emu->mode) {
+    case 0:
+        if (emu->col < emu->col_end) { emu->col++; break; }
+        emu->col = emu->col_start;
+        emu->page = emu->page < emu->page_end ? emu->page + 1 : emu->page_start;
+        break;
+    case 1:
+        if (emu->page < emu->page_end) { emu->page++; break; }
+        emu->page = emu->page_start;
+        emu->col = emu->col < emu->col_end ? emu->col + 1 : emu->col_start;
+        break;
+    default:
+        if (emu->col < 127) emu->col++;
+        break;
+    }
+}
+
+// Quantidade de parâmetros que seguem cada comando
+static uint8_t command_params(uint8_t cmd) {
+    switch (cmd) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    case 0x21: case 0x22: case 0xA3:
+        return 2;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x26: case 0x27:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static void run_command(ssd1306_emu_t *emu, const uint8_t *c) {
+    switch (c[0]) {
+    case 0x20: emu->mode = c[1] & 3; break;
+    case 0x21:
+        emu->col_start = emu->col = c[1] & 0x7F;
+        emu->col_end = c[2] & 0x7F;
+        break;
+    case 0x22:
+        emu->page_start = emu->page = c[1] & 7;
+        emu->page_end = c[2] & 7;
+        break;
+    case 0x81: emu->contrast = c[1]; break;
+    case 0x26: case 0x27:
+        emu->scroll_start = c[2] & 7;
+        emu->scroll_end = c[4] & 7;
+        break;
+    case 0x2E: emu->scrolling = false; break;
+    case 0x2F: emu->scrolling = true; break;
+    case 0xA6: emu->inverted = false; break;
+    case 0xA7: emu->inverted = true; break;
+    case 0xAE: emu->display_on = false; break;
+    case 0xAF: emu->display_on = true; break;
+    default:
+        if (c[0] >= 0xB0 && c[0] <= 0xB7) emu->page = c[0] & 7;
+        else if (c[0] < 0x10) emu->col = (emu->col & 0xF0) | c[0];
+        else if (c[0] < 0x20) emu->col = ((emu->col & 0x0F) | (c[0] << 4)) & 0x7F;
+        break;
+    }
+}
+
+static int emu_write(void *ctx, uint8_t addr, const uint8_t *data, size_t len) {
+    ssd1306_emu_t *emu = (ssd1306_emu_t *)ctx;
+
+    // START + endereço/ACK + STOP, mesmo quando o endereço não responde
+    emu->bus_bits += 1 + 9 + 1;
+    if (addr != emu->addr) return -1;
+
+    emu->transactions++;
+    emu->bytes += len;
+    emu->bus_bits += 9 * (uint64_t)len;
+
+    // Sem Co = 1, o byte de controle vale para a transação inteira
+    if (len == 0) return 0;
+    if (data[0] & 0x40) {
+        for (size_t i = 1; i < len; i++) {
+            if (emu->scrolling && emu->page >= emu->scroll_start && emu->page <= emu->scroll_end) {
+                emu->ram_writes_into_scroll++;
+            }
+            emu->ram[emu->page][emu->col] = data[i];
+            advance(emu);
+        }
+        emu->data_bytes += len - 1;
+        return (int)len;
+    }
+
+    for (size_t i = 1; i < len; ) {
+        uint8_t n = command_params(data[i]);
+        if (i + n >= len) break;     // parâmetros truncados: ignora
+        run_command(emu, &data[i]);
+        i += 1 + n;
+    }
+    emu->commands += len - 1;
+    return (int)len;
+}
+
+ssd1306_transport_t ssd1306_emu_transport(ssd1306_emu_t *emu) {
+    ssd1306_transport_t t = {
+        .write = emu_write,
+        .write_async = NULL,
+        .wait = NULL,
+        .ctx = emu
+    };
+    return t;
+}
+
+static bool emu_write_async(void *ctx, uint8_t addr, const uint8_t *data, size_t len,
+                            ssd1306_xfer_cb_t done, void *arg) {
+    ssd1306_emu_t *emu = (ssd1306_emu_t *)ctx;
+    if (emu->async.pending || len > sizeof(emu->async.copy)) return false;
+
+    emu->async.pending = true;
+    emu->async.addr = addr;
+    emu->async.data = data;
+    emu->async.len = len;
+    emu->async.done = done;
+    emu->async.arg = arg;
+    memcpy(emu->async.copy, data, len);
+    return true;
+}
+
+bool ssd1306_emu_complete(ssd1306_emu_t *emu) {
+    if (!emu->async.pending) return false;
+
+    // Libera antes do callback: done costuma iniciar a próxima transação
+    emu->async.pending = false;
+    if (memcmp(emu->async.copy, emu->async.data, emu->async.len)) emu->async_modified++;
+    bool ok = emu_write(emu, emu->async.addr, emu->async.data, emu->async.len) >= 0;
+    emu->async.done(emu->async.arg, ok);
+    return true;
+}
+
+static bool emu_wait(void *ctx, uint32_t timeout_us) {
+    (void)timeout_us;
+    ssd1306_emu_complete((ssd1306_emu_t *)ctx);
+    return true;
+}
+
+ssd1306_transport_t ssd1306_emu_transport_async(ssd1306_emu_t *emu) {
+    ssd1306_transport_t t = ssd1306_emu_transport(emu);
+    t.write_async = emu_write_async;
+    t.wait = emu_wait;
+    return t;
+}
+
+void ssd1306_init_emu(ssd1306_t *dev, ssd1306_emu_t *emu, uint8_t addr) {
+    ssd1306_transport_t t = ssd1306_emu_transport(emu);
+    ssd1306_init_transport(dev, &t, addr);
+}
+
+bool ssd1306_emu_pixel(const ssd1306_emu_t *emu, uint8_t x, uint8_t y) {
+    if (!emu->display_on || x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) return false;
+    bool on = emu->ram[y >> 3][SSD1306_COL_OFFSET + x] & (1u << (y & 7));
+    return on != emu->inverted;
+}
+
+void ssd1306_emu_write_pbm(const ssd1306_emu_t *emu, FILE *f) {
+    fprintf(f, "P4\n%d %d\n", SSD1306_WIDTH, SSD1306_HEIGHT);
+    for (uint8_t y = 0; y < SSD1306_HEIGHT; y++) {
+        for (uint8_t x = 0; x < SSD1306_WIDTH; x += 8) {
+            // No PBM bit 1 é preto: pixel aceso sai branco, como no painel
+            uint8_t bits = 0;
+            for (uint8_t i = 0; i < 8; i++) {
+                if (!ssd1306_emu_pixel(emu, x + i, y)) bits |= 0x80 >> i;
+            }
+            fputc(bits, f);
+        }
+    }
+}
+
+void ssd1306_emu_write_pgm(const ssd1306_emu_t *emu, FILE *f) {
+    // Pixel aceso com brilho proporcional ao contraste (mínimo visível em 0)
+    uint8_t lit = 64 + (emu->contrast * 191) / 255;
+
+    fprintf(f, "P5\n%d %d\n255\n", SSD1306_WIDTH, SSD1306_HEIGHT);
+    for (uint8_t y = 0; y < SSD1306_HEIGHT; y++) {
+        for (uint8_t x = 0; x < SSD1306_WIDTH; x++) {
+            fputc(ssd1306_emu_pixel(emu, x, y) ? lit : 0, f);
+        }
+    }
+}
+
+static bool save(const ssd1306_emu_t *emu, const char *path,
+                 void (*writer)(const ssd1306_emu_t *, FILE *)) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    writer(emu, f);
+    return fclose(f) == 0;
+}
+
+bool ssd1306_emu_save_pbm(const ssd1306_emu_t *emu, const char *path) {
+    return save(emu, path, ssd1306_emu_write_pbm);
+}
+
+bool ssd1306_emu_save_pgm(const ssd1306_emu_t *emu, const char *path) {
+    return save(emu, path, ssd1306_emu_write_pgm);
+}
@@ -0,0 +1,81 @@
+#ifndef SSD1306_EMU_H
+#define SSD1306_EMU_H
+
+#include <stdio.h>
+#include "ssd1306.h"
+
+// Backend de host para o ssd1306: decodifica o fluxo de comandos/dados como o
+// controlador faria e mantém uma GDDRAM simulada, sem nenhum hardware.
+// Compila no Linux só com o núcleo, p.ex.:
+//   gcc -Ilib/ssd1306 app.c lib/ssd1306/ssd1306.c lib/ssd1306/ssd1306_emu.c
+//
+// Entende endereçamento por página, horizontal e vertical, janelas 0x21/0x22,
+// display on/off, inversão, contraste e rolagem (apenas registra o estado).
+// Remapeamentos (0xA0/0xA1, 0xC0/0xC8) não são aplicados à imagem: a GDDRAM é
+// exibida na mesma orientação do framebuffer do driver.
+
+typedef struct {
+    uint8_t addr;                    // endereço I2C atendido; demais recebem NAK
+
+    uint8_t ram[8][128];             // GDDRAM completa do controlador
+    uint8_t mode;                    // 0: horizontal, 1: vertical, 2: página
+    uint8_t col, page;
+    uint8_t col_start, col_end;
+    uint8_t page_start, page_end;
+
+    bool display_on;
+    bool inverted;
+    uint8_t contrast;
+    bool scrolling;
+    uint8_t scroll_start, scroll_end;   // páginas da rolagem configurada
+
+    // Tráfego
+    uint32_t bytes;                  // bytes após o endereço, incluindo controle
+    uint32_t transactions;
+    uint32_t commands;               // bytes de comando (incluindo parâmetros)
+    uint32_t data_bytes;             // bytes escritos na GDDRAM
+    uint32_t ram_writes_into_scroll; // bytes escritos em páginas que estavam rolando
+    uint64_t bus_bits;               // bits no SCL: START, endereço+ACK, bytes+ACK, STOP
+
+    // Transação assíncrona em andamento (ssd1306_emu_transport_async)
+    struct {
+        bool pending;
+        uint8_t addr;
+        const uint8_t *data;         // lido só na conclusão, como pelo DMA
+        size_t len;
+        ssd1306_xfer_cb_t done;
+        void *arg;
+        uint8_t copy[1 + 128 * 8];   // bytes no início, para detectar alteração
+    } async;
+    uint32_t async_modified;         // transações cujos bytes mudaram antes do fim
+} ssd1306_emu_t;
+
+void ssd1306_emu_init(ssd1306_emu_t *emu, uint8_t addr);
+ssd1306_transport_t ssd1306_emu_transport(ssd1306_emu_t *emu);
+
+// Transporte com write_async: a transação fica pendente e os bytes só são
+// decodificados em ssd1306_emu_complete() (ou no wait() do transporte), que
+// então chama done. Com o endereço não atendido, done recebe ok = false
+ssd1306_transport_t ssd1306_emu_transport_async(ssd1306_emu_t *emu);
+// Conclui a transação pendente; retorna false se não havia nenhuma
+bool ssd1306_emu_complete(ssd1306_emu_t *emu);
+
+// Inicializa o display sobre o emulador (equivalente ao ssd1306_init do RP2040)
+void ssd1306_init_emu(ssd1306_t *dev, ssd1306_emu_t *emu, uint8_t addr);
+
+// Tempo estimado de barramento, em microssegundos, para um clock SCL (100k, 400k, 1M)
+uint32_t ssd1306_emu_bus_time_us(const ssd1306_emu_t *emu, uint32_t scl_hz);
+void ssd1306_emu_reset_counters(ssd1306_emu_t *emu);
+
+// Pixel visível (x, y) do painel, já considerando inversão e display desligado
+bool ssd1306_emu_pixel(const ssd1306_emu_t *emu, uint8_t x, uint8_t y);
+
+// Imagens do painel, com pixel aceso claro sobre fundo preto: PBM (1 bit) e PGM
+// (tons conforme o contraste)
+void ssd1306_emu_write_pbm(const ssd1306_emu_t *emu, FILE *f);
+void ssd1306_emu_write_pgm(const ssd1306_emu_t *emu, FILE *f);
+// Grava em arquivo; retorna false se não conseguir abrir
+bool ssd1306_emu_save_pbm(const ssd1306_emu_t *emu, const char *path);
+bool ssd1306_emu_save_pgm(const ssd1306_emu_t *emu, const char *path);
+
+#endif
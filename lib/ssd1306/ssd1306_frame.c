@@ -0,0 +1,73 @@
+#include "ssd1306_frame.h"
+#include <string.h>
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+// Fim do envio: chamado pelo DMA (IRQ) ou direto, se o transporte for síncrono
+static void flush_done(void *arg) {
+    ssd1306_frame_t *fs = (ssd1306_frame_t *)arg;
+    // Snapshot vazio: show_async chama done direto, sem nada enviado
+    if (fs->dev->win_count == 0) return;
+    uint32_t elapsed = time_us_32() - fs->flush_start_us;
+
+    fs->stats.last_flush_us = elapsed;
+    if (elapsed > fs->stats.worst_flush_us) fs->stats.worst_flush_us = elapsed;
+}
+
+static bool frame_tick(repeating_timer_t *rt) {
+    ssd1306_frame_t *fs = (ssd1306_frame_t *)rt->user_data;
+
+    if (fs->drawing || ssd1306_flush_busy(fs->dev)) {
+        fs->stats.deferred++;
+        return true;
+    }
+    if (!ssd1306_pending(fs->dev)) {
+        fs->stats.skipped++;
+        return true;
+    }
+
+    // Sujo não quer dizer diferente: se tudo voltou ao que o painel já mostra,
+    // o snapshot não gera janela e o tick conta como sem alteração
+    fs->flush_start_us = time_us_32();
+    ssd1306_show_async(fs->dev, flush_done, fs);
+    if (fs->dev->win_count > 0) {
+        fs->stats.pushed++;
+    } else {
+        fs->stats.skipped++;
+    }
+    return true;
+}
+
+bool ssd1306_frame_start(ssd1306_frame_t *fs, ssd1306_t *dev, uint32_t period_ms) {
+    memset(fs, 0, sizeof(*fs));
+    fs->dev = dev;
+    // Período negativo: o intervalo conta do início de um tick ao próximo
+    return add_repeating_timer_ms(-(int32_t)period_ms, frame_tick, fs, &fs->timer);
+}
+
+void ssd1306_frame_stop(ssd1306_frame_t *fs) {
+    cancel_repeating_timer(&fs->timer);
+    ssd1306_flush_wait(fs->dev);
+}
+
+void ssd1306_frame_begin(ssd1306_frame_t *fs) {
+    fs->drawing++;
+    __compiler_memory_barrier();
+}
+
+void ssd1306_frame_end(ssd1306_frame_t *fs) {
+    __compiler_memory_barrier();
+    fs->drawing--;
+}
+
+void ssd1306_frame_get_stats(const ssd1306_frame_t *fs, ssd1306_frame_stats_t *out) {
+    uint32_t irq = save_and_disable_interrupts();
+    memcpy(out, (const void *)&fs->stats, sizeof(*out));
+    restore_interrupts(irq);
+}
+
+void ssd1306_frame_reset_stats(ssd1306_frame_t *fs) {
+    uint32_t irq = save_and_disable_interrupts();
+    memset((void *)&fs->stats, 0, sizeof(fs->stats));
+    restore_interrupts(irq);
+}
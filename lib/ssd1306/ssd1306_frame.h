@@ -0,0 +1,41 @@
+#ifndef SSD1306_FRAME_H
+#define SSD1306_FRAME_H
+
+#include "ssd1306.h"
+#include "pico/time.h"
+
+// Agendador de quadros: um repeating_timer envia as alterações acumuladas com
+// ssd1306_show_async() no máximo uma vez por período, e não envia nada quando
+// nada mudou. Assim a fatia do barramento usada pelo display fica limitada.
+//
+// Com o agendador ativo, a aplicação não chama ssd1306_show(): todo acesso ao
+// display (desenho, efeitos, rolagem) fica entre ssd1306_frame_begin() e
+// ssd1306_frame_end(). Um tick que cair dentro desse trecho é adiado.
+
+typedef struct {
+    uint32_t pushed;          // quadros enviados
+    uint32_t skipped;         // ticks sem alteração (nada sujo ou igual ao painel)
+    uint32_t deferred;        // ticks adiados (desenho em andamento ou envio anterior)
+    uint32_t last_flush_us;   // duração do último envio (início até o fim do DMA)
+    uint32_t worst_flush_us;
+} ssd1306_frame_stats_t;
+
+typedef struct {
+    ssd1306_t *dev;
+    repeating_timer_t timer;
+    volatile uint8_t drawing;
+    uint32_t flush_start_us;
+    volatile ssd1306_frame_stats_t stats;
+} ssd1306_frame_t;
+
+// Retorna false se não houver alarme disponível
+bool ssd1306_frame_start(ssd1306_frame_t *fs, ssd1306_t *dev, uint32_t period_ms);
+void ssd1306_frame_stop(ssd1306_frame_t *fs);
+
+void ssd1306_frame_begin(ssd1306_frame_t *fs);
+void ssd1306_frame_end(ssd1306_frame_t *fs);
+
+void ssd1306_frame_get_stats(const ssd1306_frame_t *fs, ssd1306_frame_stats_t *stats);
+void ssd1306_frame_reset_stats(ssd1306_frame_t *fs);
+
+#endif
@@ -0,0 +1,212 @@
+#include "ssd1306.h"
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+// Backend I2C do RP2040 para o ssd1306: escrita bloqueante via SDK e
+// escrita assíncrona via DMA -> IC_DATA_CMD.
+//
+// Escritas de 8 bits em registradores do APB são replicadas em todas as
+// lanes do barramento e acionariam os bits CMD/STOP/RESTART do IC_DATA_CMD,
+// por isso o DMA transfere palavras de 16 bits (byte de dados + STOP no último).
+// As palavras são preparadas em blocos pequenos por controlador I2C; entre um
+// bloco e outro o controlador segura o SCL com a FIFO vazia, sem gerar STOP.
+//
+// O fim do DMA só quer dizer que a última palavra entrou na FIFO (até 16 bytes
+// e o STOP ainda por sair): o envio só termina na interrupção STOP_DET do
+// controlador. TX_ABRT (NACK, painel ausente) encerra o envio com erro.
+
+#define SSD1306_DMA_CHUNK      64
+#define SSD1306_I2C_TIMEOUT_US 200000   // quadro inteiro a 100 kHz: ~93 ms
+
+typedef struct {
+    i2c_inst_t *i2c;
+    int dma_chan;
+    const uint8_t *src;
+    size_t remaining;
+    volatile bool busy;
+    ssd1306_xfer_cb_t done;
+    void *arg;
+    uint16_t words[SSD1306_DMA_CHUNK];
+} ssd1306_i2c_bus_t;
+
+// Um contexto por controlador: painéis no mesmo barramento se revezam
+static ssd1306_i2c_bus_t buses[2];
+static bool irq_installed;
+
+static uint bus_irq(const ssd1306_i2c_bus_t *bus) {
+    return i2c_hw_index(bus->i2c) ? I2C1_IRQ : I2C0_IRQ;
+}
+
+static void bus_set_target(ssd1306_i2c_bus_t *bus, uint8_t addr) {
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+
+    // O endereço só pode ser trocado com o controlador parado
+    if (hw->tar != addr) {
+        while (hw->status & I2C_IC_STATUS_ACTIVITY_BITS) tight_loop_contents();
+        hw->enable = 0;
+        hw->tar = addr;
+        hw->enable = 1;
+    }
+}
+
+static void bus_start_chunk(ssd1306_i2c_bus_t *bus) {
+    size_t n = bus->remaining < SSD1306_DMA_CHUNK ? bus->remaining : SSD1306_DMA_CHUNK;
+
+    for (size_t i = 0; i < n; i++) bus->words[i] = bus->src[i];
+    bus->src += n;
+    bus->remaining -= n;
+    if (bus->remaining == 0) bus->words[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    dma_channel_transfer_from_buffer_now(bus->dma_chan, bus->words, n);
+}
+
+static void bus_finish(ssd1306_i2c_bus_t *bus, bool ok) {
+    i2c_get_hw(bus->i2c)->intr_mask = 0;
+    bus->busy = false;
+    if (bus->done) bus->done(bus->arg, ok);
+}
+
+// Encerra o envio com erro: para o DMA, descarta o resto da FIFO e limpa o abort
+static void bus_fail(ssd1306_i2c_bus_t *bus) {
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+
+    // Abortar o canal pode gerar uma interrupção de fim espúria (RP2040-E13)
+    dma_channel_set_irq1_enabled(bus->dma_chan, false);
+    dma_channel_abort(bus->dma_chan);
+    dma_channel_acknowledge_irq1(bus->dma_chan);
+    dma_channel_set_irq1_enabled(bus->dma_chan, true);
+    bus->remaining = 0;
+
+    // Sem TX_ABRT (timeout, SCL preso): pede o abort ao controlador
+    if (!(hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)) {
+        hw->enable |= I2C_IC_ENABLE_ABORT_BITS;
+        for (int i = 0; i < 1000 && (hw->enable & I2C_IC_ENABLE_ABORT_BITS); i++) tight_loop_contents();
+    }
+    (void)hw->clr_tx_abrt;
+    (void)hw->clr_stop_det;
+    bus_finish(bus, false);
+}
+
+static void dma_irq_handler(void) {
+    for (uint i = 0; i < count_of(buses); i++) {
+        ssd1306_i2c_bus_t *bus = &buses[i];
+        if (bus->dma_chan < 0 || !dma_channel_get_irq1_status(bus->dma_chan)) continue;
+        dma_channel_acknowledge_irq1(bus->dma_chan);
+        if (!bus->busy) continue;
+
+        if (i2c_get_hw(bus->i2c)->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+            bus_fail(bus);
+        } else if (bus->remaining) {
+            bus_start_chunk(bus);
+        } else {
+            // Última palavra na FIFO: o fim vem com o STOP (talvez já detectado)
+            i2c_get_hw(bus->i2c)->intr_mask = I2C_IC_INTR_MASK_M_TX_ABRT_BITS | I2C_IC_INTR_MASK_M_STOP_DET_BITS;
+        }
+    }
+}
+
+static void i2c_irq_handler(void) {
+    for (uint i = 0; i < count_of(buses); i++) {
+        ssd1306_i2c_bus_t *bus = &buses[i];
+        if (!bus->i2c || !bus->busy) continue;
+
+        i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+        uint32_t stat = hw->intr_stat;
+        if (stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+            bus_fail(bus);
+        } else if (stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+            (void)hw->clr_stop_det;
+            bus_finish(bus, true);
+        }
+    }
+}
+
+// Espera o envio assíncrono em andamento; estourando o tempo, aborta com erro
+static bool i2c_transport_wait(void *ctx, uint32_t timeout_us) {
+    ssd1306_i2c_bus_t *bus = (ssd1306_i2c_bus_t *)ctx;
+    absolute_time_t deadline = make_timeout_time_us(timeout_us);
+
+    while (bus->busy) {
+        if (time_reached(deadline)) {
+            uint32_t irq = save_and_disable_interrupts();
+            if (bus->busy) bus_fail(bus);
+            restore_interrupts(irq);
+            return false;
+        }
+        tight_loop_contents();
+    }
+    return true;
+}
+
+static int i2c_transport_write(void *ctx, uint8_t addr, const uint8_t *data, size_t len) {
+    ssd1306_i2c_bus_t *bus = (ssd1306_i2c_bus_t *)ctx;
+    i2c_transport_wait(bus, SSD1306_I2C_TIMEOUT_US);
+    return i2c_write_timeout_us(bus->i2c, addr, data, len, false, SSD1306_I2C_TIMEOUT_US);
+}
+
+static bool i2c_transport_write_async(void *ctx, uint8_t addr, const uint8_t *data, size_t len,
+                                      ssd1306_xfer_cb_t done, void *arg) {
+    ssd1306_i2c_bus_t *bus = (ssd1306_i2c_bus_t *)ctx;
+
+    if (bus->dma_chan < 0 || bus->busy || len == 0) return false;
+
+    bus_set_target(bus, addr);
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+    (void)hw->clr_tx_abrt;
+    (void)hw->clr_stop_det;
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS;
+
+    bus->busy = true;
+    bus->src = data;
+    bus->remaining = len;
+    bus->done = done;
+    bus->arg = arg;
+    // Abort a qualquer momento; o STOP só interessa depois do último bloco
+    hw->intr_mask = I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+    bus_start_chunk(bus);
+    return true;
+}
+
+static ssd1306_i2c_bus_t *bus_get(i2c_inst_t *i2c) {
+    ssd1306_i2c_bus_t *bus = &buses[i2c_hw_index(i2c)];
+    if (bus->i2c) return bus;
+
+    bus->i2c = i2c;
+    bus->dma_chan = dma_claim_unused_channel(false);
+    if (bus->dma_chan < 0) return bus;
+
+    dma_channel_config c = dma_channel_get_default_config(bus->dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(i2c, true));
+    dma_channel_configure(bus->dma_chan, &c, &i2c_get_hw(i2c)->data_cmd, NULL, 0, false);
+    dma_channel_set_irq1_enabled(bus->dma_chan, true);
+
+    if (!irq_installed) {
+        irq_add_shared_handler(DMA_IRQ_1, dma_irq_handler,
+                               PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_1, true);
+        irq_installed = true;
+    }
+    // Interrupções do controlador só ficam habilitadas (intr_mask) durante um
+    // envio assíncrono; as escritas bloqueantes do SDK continuam por polling
+    i2c_get_hw(i2c)->intr_mask = 0;
+    irq_add_shared_handler(bus_irq(bus), i2c_irq_handler,
+                           PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(bus_irq(bus), true);
+    return bus;
+}
+
+void ssd1306_init(ssd1306_t *dev, struct i2c_inst *i2c, uint8_t addr) {
+    ssd1306_transport_t t = {
+        .write = i2c_transport_write,
+        .write_async = i2c_transport_write_async,
+        .wait = i2c_transport_wait,
+        .ctx = bus_get(i2c)
+    };
+    ssd1306_init_transport(dev, &t, addr);
+}
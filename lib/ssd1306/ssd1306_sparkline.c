@@ -0,0 +1,105 @@
+#include "ssd1306_sparkline.h"
+
+static uint8_t col_prev(const ssd1306_sparkline_t *sp, uint8_t col) {
+    return col ? col - 1 : sp->width - 1;
+}
+
+static uint8_t value_y(const ssd1306_sparkline_t *sp, int32_t value) {
+    uint8_t top = sp->page0 * 8;
+    uint8_t bottom = sp->page1 * 8 + 7;
+    int64_t h = bottom - top;
+    return bottom - (uint8_t)((int64_t)(value - sp->lo) * h / (sp->hi - sp->lo));
+}
+
+// Desenha a coluna col; prev_y < 0 indica que não há amostra anterior a ligar
+static void draw_column(ssd1306_t *dev, const ssd1306_sparkline_t *sp, uint8_t col, int prev_y) {
+    uint8_t x = sp->x + col;
+    uint8_t y = value_y(sp, sp->values[col]);
+
+    ssd1306_draw_vline(dev, x, sp->page0 * 8, sp->page1 * 8 + 7, false);
+    ssd1306_draw_vline(dev, x, prev_y < 0 ? y : (uint8_t)prev_y, y, true);
+}
+
+static void clear_column(ssd1306_t *dev, const ssd1306_sparkline_t *sp, uint8_t col) {
+    ssd1306_draw_vline(dev, sp->x + col, sp->page0 * 8, sp->page1 * 8 + 7, false);
+}
+
+// Faixa ideal para os dados: extremos do histórico com 1/4 de margem de cada lado
+static void target_scale(const ssd1306_sparkline_t *sp, int32_t *lo, int32_t *hi) {
+    int32_t mn = sp->values[col_prev(sp, sp->head)];
+    int32_t mx = mn;
+    uint8_t col = sp->head;
+    for (uint8_t i = 0; i < sp->count; i++) {
+        col = col_prev(sp, col);
+        if (sp->values[col] < mn) mn = sp->values[col];
+        if (sp->values[col] > mx) mx = sp->values[col];
+    }
+
+    int32_t span = mx - mn;
+    if (span < sp->min_span) span = sp->min_span;
+    if (span < 1) span = 1;
+    int32_t mid = mn + (mx - mn) / 2;
+    *lo = mid - span / 2 - span / 4;
+    *hi = *lo + span + span / 2;
+}
+
+// Guarda a amostra na coluna do cursor; retorna true se a escala mudou
+static bool add_sample(ssd1306_sparkline_t *sp, int32_t value) {
+    sp->values[sp->head] = value;
+    if (sp->count < sp->width - 1) sp->count++;
+    sp->head = sp->head + 1 < sp->width ? sp->head + 1 : 0;
+
+    bool outside = sp->lo >= sp->hi || value < sp->lo || value > sp->hi;
+    int32_t lo, hi;
+    target_scale(sp, &lo, &hi);
+    if (!outside && (sp->hi - sp->lo) / 2 <= hi - lo) return false;
+
+    sp->lo = lo;
+    sp->hi = hi;
+    sp->rescales++;
+    return true;
+}
+
+void ssd1306_sparkline_add(ssd1306_sparkline_t *sp, int32_t value) {
+    add_sample(sp, value);
+}
+
+void ssd1306_sparkline_push(ssd1306_t *dev, ssd1306_sparkline_t *sp, int32_t value) {
+    if (add_sample(sp, value)) {
+        ssd1306_sparkline_draw(dev, sp);
+        return;
+    }
+
+    uint8_t col = col_prev(sp, sp->head);
+    int prev_y = sp->count > 1 ? value_y(sp, sp->values[col_prev(sp, col)]) : -1;
+    draw_column(dev, sp, col, prev_y);
+    clear_column(dev, sp, sp->head);
+
+    // Histórico cheio: a amostra mais antiga perdeu a anterior, desfaz a ligação
+    if (sp->count == sp->width - 1) {
+        draw_column(dev, sp, sp->head + 1 < sp->width ? sp->head + 1 : 0, -1);
+    }
+}
+
+void ssd1306_sparkline_draw(ssd1306_t *dev, ssd1306_sparkline_t *sp) {
+    // Da amostra mais antiga para a mais nova, seguida das colunas vazias
+    uint8_t col = sp->head;
+    for (uint8_t i = 0; i < sp->width - 1 - sp->count; i++) {
+        col = col + 1 < sp->width ? col + 1 : 0;
+        clear_column(dev, sp, col);
+    }
+
+    int prev_y = -1;
+    for (uint8_t i = 0; i < sp->count; i++) {
+        col = col + 1 < sp->width ? col + 1 : 0;
+        draw_column(dev, sp, col, prev_y);
+        prev_y = value_y(sp, sp->values[col]);
+    }
+    clear_column(dev, sp, sp->head);
+}
+
+void ssd1306_sparkline_reset(ssd1306_sparkline_t *sp) {
+    sp->head = 0;
+    sp->count = 0;
+    sp->lo = sp->hi = 0;
+}
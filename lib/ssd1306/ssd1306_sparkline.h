@@ -0,0 +1,39 @@
+#ifndef SSD1306_SPARKLINE_H
+#define SSD1306_SPARKLINE_H
+
+#include "ssd1306.h"
+
+// Gráfico de histórico em varredura: cada amostra nova ocupa a coluna do cursor,
+// que avança e dá a volta como num osciloscópio, com uma coluna de folga apagada
+// à frente. Por amostra só mudam a coluna nova, a folga e a mais antiga, e só os
+// bytes dessas colunas vão ao barramento; o gráfico inteiro é redesenhado apenas quando
+// a escala muda.
+//
+// A escala se ajusta sozinha com histerese: expande quando uma amostra sai da
+// faixa e só encolhe quando os dados passam a ocupar menos da metade dela.
+
+typedef struct {
+    uint8_t x, width;          // colunas x..x+width-1 (width >= 2)
+    uint8_t page0, page1;      // páginas ocupadas
+    int32_t min_span;          // faixa mínima da escala (evita ampliar ruído)
+
+    int32_t values[SSD1306_WIDTH];  // amostras indexadas pela coluna em que estão
+    uint8_t head;              // coluna da próxima amostra
+    uint8_t count;             // amostras visíveis (até width - 1)
+    int32_t lo, hi;            // escala atual
+    uint32_t rescales;         // redesenhos completos por troca de escala
+} ssd1306_sparkline_t;
+
+#define SSD1306_SPARKLINE(x_, width_, page0_, page1_, min_span_) \
+    { .x = (x_), .width = (width_), .page0 = (page0_), .page1 = (page1_), .min_span = (min_span_) }
+
+// Guarda a amostra (atualizando a escala) sem desenhar; use com o gráfico fora da tela
+void ssd1306_sparkline_add(ssd1306_sparkline_t *sp, int32_t value);
+// Guarda e desenha só a coluna nova e a folga (ou tudo, se a escala mudou)
+void ssd1306_sparkline_push(ssd1306_t *dev, ssd1306_sparkline_t *sp, int32_t value);
+// Redesenha a área inteira (p.ex. ao voltar para a tela do gráfico)
+void ssd1306_sparkline_draw(ssd1306_t *dev, ssd1306_sparkline_t *sp);
+// Descarta o histórico
+void ssd1306_sparkline_reset(ssd1306_sparkline_t *sp);
+
+#endif
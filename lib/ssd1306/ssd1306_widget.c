@@ -0,0 +1,131 @@
+#include "ssd1306_widget.h"
+#include <string.h>
+
+#define CHAR_W 6
+
+static const int32_t pow10_tab[] = { 1, 10, 100, 1000, 10000 };
+
+static void draw_blank(ssd1306_t *dev, uint8_t x, uint8_t y, uint8_t count) {
+    char spaces[SSD1306_WIDTH / CHAR_W + 1];
+    if (count > sizeof(spaces) - 1) count = sizeof(spaces) - 1;
+    memset(spaces, ' ', count);
+    spaces[count] = '\0';
+    ssd1306_draw_string(dev, x, y, spaces);
+}
+
+void ssd1306_label_draw(ssd1306_t *dev, ssd1306_label_t *label) {
+    if (label->drawn) return;
+    ssd1306_draw_string(dev, label->x, label->y, label->text);
+    strncpy(label->shown, label->text, sizeof(label->shown) - 1);
+    label->shown[sizeof(label->shown) - 1] = '\0';
+    label->drawn = true;
+}
+
+void ssd1306_label_set(ssd1306_t *dev, ssd1306_label_t *label, const char *text) {
+    if (label->drawn && strncmp(text, label->shown, sizeof(label->shown) - 1) == 0) return;
+
+    uint8_t old_len = label->drawn ? strlen(label->shown) : 0;
+    label->text = text;
+    label->drawn = false;
+    ssd1306_label_draw(dev, label);
+
+    uint8_t new_len = strlen(label->shown);
+    if (new_len < old_len) {
+        draw_blank(dev, label->x + new_len * CHAR_W, label->y, old_len - new_len);
+    }
+}
+
+void ssd1306_label_reset(ssd1306_label_t *label) {
+    label->drawn = false;
+}
+
+// Formata em ponto fixo, alinhado à direita em 'width' caracteres, sem printf.
+// Se não couber (ou for INT32_MIN, valor fora da faixa), preenche com '*'
+static void format_fixed(char *out, uint8_t width, int32_t value, uint8_t precision) {
+    bool neg = value < 0;
+    uint32_t u = neg ? -(uint32_t)value : (uint32_t)value;
+    char *p = out + width;
+    *p = '\0';
+    if (value == INT32_MIN) goto overflow;
+
+#define PUT(ch) do { if (p == out) goto overflow; *--p = (ch); } while (0)
+    for (uint8_t i = 0; i < precision; i++) {
+        PUT('0' + u % 10);
+        u /= 10;
+    }
+    if (precision) PUT('.');
+    do {
+        PUT('0' + u % 10);
+        u /= 10;
+    } while (u);
+    if (neg) PUT('-');
+#undef PUT
+
+    while (p > out) *--p = ' ';
+    return;
+
+overflow:
+    memset(out, '*', width);
+}
+
+void ssd1306_number_set(ssd1306_t *dev, ssd1306_number_t *num, float value) {
+    float scaled = value * (float)pow10_tab[num->precision];
+
+    // Converter para int32 fora da faixa (ou NaN) é indefinido: vira INT32_MIN antes
+    int32_t fixed;
+    if (!(scaled > -2.0e9f && scaled < 2.0e9f)) {
+        fixed = INT32_MIN;
+    } else {
+        fixed = (int32_t)(scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+    }
+    ssd1306_number_set_fixed(dev, num, fixed);
+}
+
+void ssd1306_number_set_fixed(ssd1306_t *dev, ssd1306_number_t *num, int32_t scaled) {
+    if (num->drawn && scaled == num->shown) return;
+
+    char text[16];
+    uint8_t width = num->width < sizeof(text) ? num->width : sizeof(text) - 1;
+    format_fixed(text, width, scaled, num->precision);
+    ssd1306_draw_string(dev, num->x, num->y, text);
+
+    if (!num->drawn && num->suffix) {
+        ssd1306_draw_string(dev, num->x + width * CHAR_W, num->y, num->suffix);
+    }
+    num->shown = scaled;
+    num->drawn = true;
+}
+
+void ssd1306_number_reset(ssd1306_number_t *num) {
+    num->drawn = false;
+}
+
+static void blink_draw(ssd1306_t *dev, ssd1306_blink_t *blink) {
+    if (blink->visible) {
+        ssd1306_draw_string(dev, blink->x, blink->y, blink->text);
+    } else {
+        draw_blank(dev, blink->x, blink->y, strlen(blink->text));
+    }
+}
+
+void ssd1306_blink_set_active(ssd1306_t *dev, ssd1306_blink_t *blink, bool active, uint32_t now_ms) {
+    if (blink->active == active) return;
+
+    blink->active = active;
+    blink->visible = active;
+    blink->last_toggle_ms = now_ms;
+    blink_draw(dev, blink);
+}
+
+void ssd1306_blink_update(ssd1306_t *dev, ssd1306_blink_t *blink, uint32_t now_ms) {
+    if (!blink->active || now_ms - blink->last_toggle_ms < blink->period_ms) return;
+
+    blink->visible = !blink->visible;
+    blink->last_toggle_ms = now_ms;
+    blink_draw(dev, blink);
+}
+
+void ssd1306_blink_reset(ssd1306_blink_t *blink) {
+    blink->active = false;
+    blink->visible = false;
+}
@@ -0,0 +1,66 @@
+#ifndef SSD1306_WIDGET_H
+#define SSD1306_WIDGET_H
+
+#include "ssd1306.h"
+
+// Camada de widgets em modo retido sobre o ssd1306: cada widget lembra o que
+// já desenhou e só redesenha (e suja) o próprio retângulo quando o conteúdo
+// exibido muda. Não use ssd1306_clear() entre quadros; ao trocar de tela,
+// limpe o display e chame o *_reset() dos widgets da nova tela.
+
+// Texto fixo (títulos, rótulos)
+typedef struct {
+    uint8_t x, y;
+    const char *text;
+    char shown[SSD1306_WIDTH / 6 + 1];  // cópia do texto desenhado
+    bool drawn;
+} ssd1306_label_t;
+
+// Número com largura fixa (em caracteres, alinhado à direita) e casas decimais
+typedef struct {
+    uint8_t x, y;
+    uint8_t width;          // caracteres do número, incluindo sinal e ponto
+    uint8_t precision;      // casas decimais (0..4)
+    const char *suffix;     // unidade desenhada após o número (pode ser NULL)
+    int32_t shown;          // valor exibido, em unidades de 10^-precision
+    bool drawn;
+} ssd1306_number_t;
+
+// Texto de alerta piscante: só o retângulo do texto é redesenhado a cada troca
+typedef struct {
+    uint8_t x, y;
+    const char *text;
+    uint32_t period_ms;     // meio período: tempo aceso e tempo apagado
+    bool active;
+    bool visible;
+    uint32_t last_toggle_ms;
+} ssd1306_blink_t;
+
+#define SSD1306_LABEL(x_, y_, text_) \
+    { .x = (x_), .y = (y_), .text = (text_) }
+#define SSD1306_NUMBER(x_, y_, width_, precision_, suffix_) \
+    { .x = (x_), .y = (y_), .width = (width_), .precision = (precision_), .suffix = (suffix_) }
+#define SSD1306_BLINK(x_, y_, text_, period_ms_) \
+    { .x = (x_), .y = (y_), .text = (text_), .period_ms = (period_ms_) }
+
+void ssd1306_label_draw(ssd1306_t *dev, ssd1306_label_t *label);
+void ssd1306_label_set(ssd1306_t *dev, ssd1306_label_t *label, const char *text);
+
+// Atualiza a partir de float; a conversão para texto só ocorre se os dígitos mudarem.
+// Valores fora da faixa de int32 (e NaN) aparecem como '*'
+void ssd1306_number_set(ssd1306_t *dev, ssd1306_number_t *num, float value);
+// Atualiza a partir de um valor já em ponto fixo (unidades de 10^-precision);
+// INT32_MIN indica fora da faixa
+void ssd1306_number_set_fixed(ssd1306_t *dev, ssd1306_number_t *num, int32_t scaled);
+
+// Liga (aceso a partir de now_ms) ou desliga (apaga o texto) o alerta
+void ssd1306_blink_set_active(ssd1306_t *dev, ssd1306_blink_t *blink, bool active, uint32_t now_ms);
+// Alterna aceso/apagado a cada period_ms; chamar com frequência (a cada quadro)
+void ssd1306_blink_update(ssd1306_t *dev, ssd1306_blink_t *blink, uint32_t now_ms);
+
+// Esquece o estado desenhado (após limpar a tela), forçando o próximo desenho
+void ssd1306_label_reset(ssd1306_label_t *label);
+void ssd1306_number_reset(ssd1306_number_t *num);
+void ssd1306_blink_reset(ssd1306_blink_t *blink);
+
+#endif
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+# Gera imu_trace.csv: amostras brutas do MPU6050 (±2 g, ±500 °/s, 100 Hz) de
+# um movimento conhecido, com ruído, bias do giroscópio, aceleração linear
+# nos movimentos rápidos, quantização e jitter no instante da amostra.
+# Colunas: t_us, ax, ay, az, gx, gy, gz (brutos), pitch, roll (verdade, graus).
+# Determinístico (semente fixa): rodar de novo produz o mesmo arquivo.
+
+import math
+import random
+
+RATE_HZ = 100
+SECONDS = 20
+ACCEL_LSB_G = 16384.0
+GYRO_LSB_DPS = 65.536
+GYRO_BIAS_DPS = (0.6, -0.4, 0.3)
+
+rng = random.Random(6050)
+
+
+def smooth(t, t0, t1):
+    # 0 -> 1 entre t0 e t1 (cosseno)
+    if t <= t0:
+        return 0.0
+    if t >= t1:
+        return 1.0
+    return 0.5 - 0.5 * math.cos(math.pi * (t - t0) / (t1 - t0))
+
+
+def attitude(t):
+    # pitch, roll em graus
+    pitch = 45 * smooth(t, 2, 3) - 45 * smooth(t, 5, 6)
+    roll = -30 * smooth(t, 3, 4) + 30 * smooth(t, 6, 7)
+    if 7 <= t < 13:
+        pitch += 30 * math.sin(2 * math.pi * 0.5 * (t - 7))
+        roll += 20 * math.sin(2 * math.pi * 0.3 * (t - 7))
+    # virada rápida até 80° de pitch e volta
+    pitch += 80 * smooth(t, 14, 14.6) - 80 * smooth(t, 16, 16.6)
+    return pitch, roll
+
+
+def clamp16(v):
+    return max(-32768, min(32767, int(round(v))))
+
+
+def main():
+    dt = 1.0 / RATE_HZ
+    h = 1e-4
+    with open("imu_trace.csv", "w") as f:
+        f.write("# t_us,ax,ay,az,gx,gy,gz,pitch_deg,roll_deg\n")
+        for i in range(RATE_HZ * SECONDS):
+            t = i * dt + rng.uniform(-200e-6, 200e-6)
+            th, ph = attitude(t)
+            th1, ph1 = attitude(t + h)
+            th0, ph0 = attitude(t - h)
+            dth = (th1 - th0) / (2 * h)
+            dph = (ph1 - ph0) / (2 * h)
+            ddth = (th1 - 2 * th + th0) / (h * h)
+
+            thr, phr = math.radians(th), math.radians(ph)
+            # Gravidade no corpo (roll = atan2(ay, az), pitch = atan2(-ax, |ay,az|))
+            a = [-math.sin(thr),
+                 math.sin(phr) * math.cos(thr),
+                 math.cos(phr) * math.cos(thr)]
+            # Sensor 5 cm fora do eixo de pitch: aceleração tangencial
+            a[0] += 0.05 * math.radians(ddth) / 9.81
+            # Taxas no corpo (sem guinada): p = roll', q = pitch' cos(roll), r = -pitch' sin(roll)
+            g = [dph, dth * math.cos(phr), -dth * math.sin(phr)]
+
+            raw_a = [clamp16((a[k] + rng.gauss(0, 0.01)) * ACCEL_LSB_G) for k in range(3)]
+            raw_g = [clamp16((g[k] + GYRO_BIAS_DPS[k] + rng.gauss(0, 0.15)) * GYRO_LSB_DPS)
+                     for k in range(3)]
+            t_us = int(round(t * 1e6)) + 1000000
+            f.write("%d,%d,%d,%d,%d,%d,%d,%.3f,%.3f\n" %
+                    (t_us, *raw_a, *raw_g, th, ph))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,47 @@
+#ifndef GOLDEN_H
+#define GOLDEN_H
+
+// Comparação da imagem do painel emulado com um PBM de referência em
+// tests/golden/. A imagem obtida é gravada no diretório corrente (build) para
+// inspeção; com UPDATE_GOLDEN=1 no ambiente ela substitui a referência.
+
+#include <stdlib.h>
+#include <string.h>
+#include "ssd1306_emu.h"
+#include "test_util.h"
+
+#ifndef GOLDEN_DIR
+#define GOLDEN_DIR "golden"
+#endif
+
+static inline long golden_read(const char *path, char *buf, long size) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return -1;
+    long n = (long)fread(buf, 1, size, f);
+    fclose(f);
+    return n;
+}
+
+static inline void golden_check(const ssd1306_emu_t *emu, const char *name) {
+    char actual[64], golden[256];
+    snprintf(actual, sizeof(actual), "%s.pbm", name);
+    snprintf(golden, sizeof(golden), "%s/%s.pbm", GOLDEN_DIR, name);
+
+    const char *update = getenv("UPDATE_GOLDEN");
+    if (update && *update == '1') {
+        CHECKF(ssd1306_emu_save_pbm(emu, golden), "%s", golden);
+        return;
+    }
+    if (!ssd1306_emu_save_pbm(emu, actual)) {
+        CHECKF(0, "não gravou %s", actual);
+        return;
+    }
+
+    static char a[2 * 1024], g[2 * 1024];
+    long na = golden_read(actual, a, sizeof(a));
+    long ng = golden_read(golden, g, sizeof(g));
+    CHECKF(ng > 0, "sem referência %s", golden);
+    CHECKF(na == ng && memcmp(a, g, na) == 0, "%s difere de %s", actual, golden);
+}
+
+#endif
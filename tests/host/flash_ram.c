@@ -0,0 +1,65 @@
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include <stdbool.h>
+#include <string.h>
+
+uint8_t host_flash[PICO_FLASH_SIZE_BYTES];
+host_flash_stats_t host_flash_stats;
+uint32_t host_irq_disables;
+
+static long budget = -1;
+static jmp_buf *cut_jump;
+static uint32_t noise = 0x2545F491;
+
+void host_flash_cut_in(long units, jmp_buf *jump) {
+    budget = units;
+    cut_jump = jump;
+}
+
+static uint8_t random_byte(void) {
+    noise ^= noise << 13;
+    noise ^= noise >> 17;
+    noise ^= noise << 5;
+    return (uint8_t)noise;
+}
+
+// Consome uma unidade; false quando a energia acaba nesta
+static bool spend(void) {
+    if (budget < 0) return true;
+    if (budget == 0) return false;
+    budget--;
+    return true;
+}
+
+static void power_cut(void) {
+    budget = -1;
+    host_flash_stats.cuts++;
+    longjmp(*cut_jump, 1);
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    host_flash_stats.programs += (uint32_t)((count + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE);
+    for (size_t i = 0; i < count; i++) {
+        uint8_t *b = &host_flash[flash_offs + i];
+        // 0xFF não altera o byte (preenchimento da página); o resto precisa estar apagado
+        if (data[i] != 0xFF && (data[i] & ~*b)) host_flash_stats.bad_programs++;
+        if (!spend()) {
+            *b &= data[i] | random_byte();  // parte dos bits chegou a zerar
+            power_cut();
+        }
+        *b &= data[i];
+    }
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    host_flash_stats.erases += (uint32_t)(count / FLASH_SECTOR_SIZE);
+    for (size_t at = 0; at < count; at += FLASH_PAGE_SIZE) {
+        uint8_t *p = &host_flash[flash_offs + at];
+        if (!spend()) {
+            // Apagamento interrompido: a página em curso fica com lixo
+            for (size_t i = 0; i < FLASH_PAGE_SIZE; i++) p[i] |= random_byte();
+            power_cut();
+        }
+        memset(p, 0xFF, FLASH_PAGE_SIZE);
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef HOST_HARDWARE_FLASH_H
+#define HOST_HARDWARE_FLASH_H
+
+// Flash do host: um vetor em RAM (host_flash, em host/flash_ram.c) lido
+// direto via XIP_BASE, com a semântica da NOR: programar só zera bits, apagar
+// deixa o setor em 0xFF. O teste pode cortar a energia no meio de uma
+// operação (host_flash_cut_in).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <setjmp.h>
+
+#define FLASH_PAGE_SIZE   256u
+#define FLASH_SECTOR_SIZE 4096u
+#ifndef PICO_FLASH_SIZE_BYTES
+#define PICO_FLASH_SIZE_BYTES (64u * 1024)   // só o fim da flash é usado
+#endif
+
+extern uint8_t host_flash[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)host_flash)
+
+typedef struct {
+    uint32_t programs;      // páginas programadas
+    uint32_t erases;        // setores apagados
+    uint32_t bad_programs;  // bytes gravados sobre bits já zerados (sem apagar)
+    uint32_t cuts;          // cortes de energia simulados
+} host_flash_stats_t;
+
+extern host_flash_stats_t host_flash_stats;
+
+// Corta a energia depois de 'units' unidades de trabalho (1 por byte
+// programado, 1 por página apagada): a operação em curso fica pela metade e o
+// controle volta por longjmp(*jump, 1). units < 0 desliga o corte
+void host_flash_cut_in(long units, jmp_buf *jump);
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+void flash_range_erase(uint32_t flash_offs, size_t count);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef HOST_HARDWARE_I2C_H
+#define HOST_HARDWARE_I2C_H
+
+// I2C do host: as funções de transferência são implementadas pelo mock de cada
+// teste (registradores do dispositivo simulado)
+
+#include "pico/stdlib.h"
+
+typedef struct i2c_inst i2c_inst_t;
+extern i2c_inst_t *const host_i2c0, *const host_i2c1;
+#define i2c0 host_i2c0
+#define i2c1 host_i2c1
+
+#define PICO_ERROR_GENERIC -1
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+// Substituto mínimo do pico/stdlib.h para os testes de host: só o que as
+// bibliotecas testadas usam. Tempo simulado (host_time_us), GPIO sem efeito.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+enum { GPIO_FUNC_I2C = 3, GPIO_IN = 0, GPIO_OUT = 1 };
+enum { GPIO_IRQ_LEVEL_LOW = 1, GPIO_IRQ_LEVEL_HIGH = 2, GPIO_IRQ_EDGE_FALL = 4, GPIO_IRQ_EDGE_RISE = 8 };
+
+// Relógio simulado: avança só com sleep_ms/sleep_us
+extern uint64_t host_time_us;
+
+static inline uint32_t time_us_32(void) { return (uint32_t)host_time_us; }
+static inline uint64_t time_us_64(void) { return host_time_us; }
+static inline void sleep_us(uint64_t us) { host_time_us += us; }
+static inline void sleep_ms(uint32_t ms) { host_time_us += (uint64_t)ms * 1000; }
+
+static inline void gpio_init(uint gpio) { (void)gpio; }
+static inline void gpio_set_dir(uint gpio, bool out) { (void)gpio; (void)out; }
+static inline void gpio_pull_up(uint gpio) { (void)gpio; }
+static inline void gpio_set_function(uint gpio, int fn) { (void)gpio; (void)fn; }
+static inline void gpio_set_irq_enabled(uint gpio, uint32_t events, bool on) { (void)gpio; (void)events; (void)on; }
+static inline void gpio_add_raw_irq_handler(uint gpio, void (*handler)(void)) { (void)gpio; (void)handler; }
+static inline void gpio_remove_raw_irq_handler(uint gpio, void (*handler)(void)) { (void)gpio; (void)handler; }
+static inline void gpio_acknowledge_irq(uint gpio, uint32_t events) { (void)gpio; (void)events; }
+static inline uint32_t gpio_get_irq_event_mask(uint gpio) { (void)gpio; return 0; }
+
+#endif
@@ -0,0 +1,137 @@
+// buzzer_pattern: o sequenciador é chamado como o alarme do buzzer_pwm faria
+// (aplica o tom, reagenda após o tempo devolvido) e a linha do tempo
+// resultante é conferida: duração dos passos, repetições, fim do padrão e as
+// frequências de cada fatia das varreduras.
+
+#include "buzzer_pattern.h"
+#include "test_util.h"
+
+typedef struct {
+    uint32_t t_ms;          // instante em que o tom começa
+    uint8_t channel;
+    uint16_t freq_hz;
+    uint32_t ms;
+} event_t;
+
+static event_t ev[4096];
+static int n_ev;
+
+// Roda o padrão até terminar (ou max eventos); retorna a duração total
+static uint32_t run(const buzzer_pattern_t *p, int max) {
+    buzzer_seq_t seq;
+    buzzer_seq_start(&seq, p);
+    uint32_t t = 0;
+    for (n_ev = 0; n_ev < max; ) {
+        buzzer_tone_t tone;
+        uint32_t ms = buzzer_seq_next(&seq, &tone);
+        if (!ms) {
+            CHECK(buzzer_seq_done(&seq));
+            CHECK(tone.freq_hz == 0);
+            break;
+        }
+        ev[n_ev++] = (event_t){ t, tone.channel, tone.freq_hz, ms };
+        t += ms;
+    }
+    return t;
+}
+
+// Padrão de alerta do MPU6050_Servo: bipes alternando os buzzers
+static void test_steps_and_repeats(void) {
+    static const buzzer_step_t steps[] = {
+        {0, 2000, 0, 100}, {0, 0, 0, 300},
+        {1, 2000, 0, 100}, {1, 0, 0, 300},
+    };
+    static const buzzer_pattern_t p = BUZZER_PATTERN(steps, 3);
+
+    uint32_t total = run(&p, 100);
+    CHECK(n_ev == 12);
+    CHECK(total == 3 * 800);
+    for (int i = 0; i < n_ev; i++) {
+        const buzzer_step_t *st = &steps[i % 4];
+        CHECKF(ev[i].t_ms == (uint32_t)(i / 4) * 800 + (i % 4 / 2) * 400 + (i % 2) * 100,
+               "evento %d em %u ms", i, ev[i].t_ms);
+        CHECK(ev[i].channel == st->channel);
+        CHECK(ev[i].freq_hz == st->freq_hz);
+        CHECK(ev[i].ms == st->duration_ms);
+    }
+}
+
+static void test_repeat_forever(void) {
+    static const buzzer_step_t steps[] = { {0, 440, 0, 50}, {0, 0, 0, 50} };
+    static const buzzer_pattern_t p = BUZZER_PATTERN(steps, 0);
+
+    buzzer_seq_t seq;
+    buzzer_seq_start(&seq, &p);
+    buzzer_tone_t tone;
+    uint32_t t = 0;
+    for (int i = 0; i < 10000; i++) {
+        uint32_t ms = buzzer_seq_next(&seq, &tone);
+        CHECK(ms == 50);
+        CHECK(tone.freq_hz == (i % 2 ? 0 : 440));
+        t += ms;
+    }
+    CHECK(!buzzer_seq_done(&seq));
+    CHECK(t == 500000);
+
+    // buzzer_stop reinicia com NULL
+    buzzer_seq_start(&seq, NULL);
+    CHECK(buzzer_seq_done(&seq));
+    CHECK(buzzer_seq_next(&seq, &tone) == 0);
+}
+
+// Varredura: fatias de BUZZER_SWEEP_MS (a última com o resto), frequência
+// interpolada no início de cada fatia, nunca chegando ao valor final
+static void check_sweep(uint16_t f0, uint16_t f1, uint16_t duration) {
+    const buzzer_step_t steps[] = { {1, f0, f1, duration}, {0, 700, 0, 20} };
+    const buzzer_pattern_t p = BUZZER_PATTERN(steps, 2);
+
+    uint32_t total = run(&p, 1000);
+    int slices = (duration + BUZZER_SWEEP_MS - 1) / BUZZER_SWEEP_MS;
+    CHECKF(n_ev == 2 * (slices + 1), "varredura %u-%u/%u: %d eventos", f0, f1, duration, n_ev);
+    CHECK(total == 2u * (duration + 20));
+
+    for (int rep = 0; rep < 2; rep++) {
+        const event_t *e = &ev[rep * (slices + 1)];
+        uint32_t start = rep * (duration + 20);
+        for (int k = 0; k < slices; k++) {
+            uint32_t elapsed = k * BUZZER_SWEEP_MS;
+            uint32_t left = duration - elapsed;
+            uint16_t expected = (uint16_t)(f0 + ((int32_t)f1 - f0) * (int32_t)elapsed / duration);
+            CHECK(e[k].channel == 1);
+            CHECK(e[k].t_ms == start + elapsed);
+            CHECK(e[k].ms == (left < BUZZER_SWEEP_MS ? left : BUZZER_SWEEP_MS));
+            CHECKF(e[k].freq_hz == expected, "varredura %u-%u, fatia %d: %u Hz, esperado %u",
+                   f0, f1, k, e[k].freq_hz, expected);
+            if (k) CHECK(f1 > f0 ? e[k].freq_hz > e[k - 1].freq_hz : e[k].freq_hz < e[k - 1].freq_hz);
+            CHECK(e[k].freq_hz != f1);
+        }
+        // Depois da varredura o passo seguinte toca normalmente
+        CHECK(e[slices].channel == 0 && e[slices].freq_hz == 700 && e[slices].ms == 20);
+        CHECK(e[slices].t_ms == start + duration);
+    }
+}
+
+static void test_edges(void) {
+    // freq_end igual a freq: tom fixo; duração 0 vira 1 ms
+    static const buzzer_step_t steps[] = { {1, 1500, 1500, 40}, {0, 900, 0, 0} };
+    static const buzzer_pattern_t p = BUZZER_PATTERN(steps, 1);
+    CHECK(run(&p, 10) == 41);
+    CHECK(n_ev == 2);
+    CHECK(ev[0].freq_hz == 1500 && ev[0].ms == 40);
+    CHECK(ev[1].freq_hz == 900 && ev[1].ms == 1);
+
+    // Padrão vazio termina já
+    static const buzzer_pattern_t empty = { .steps = steps, .count = 0, .repeat = 1 };
+    CHECK(run(&empty, 10) == 0);
+    CHECK(n_ev == 0);
+}
+
+int main(void) {
+    test_steps_and_repeats();
+    test_repeat_forever();
+    check_sweep(1000, 2000, 95);
+    check_sweep(3000, 1000, 200);
+    check_sweep(500, 4000, 7);
+    test_edges();
+    return test_result();
+}
@@ -0,0 +1,220 @@
+// flash_kv sobre a flash em RAM do host (host/flash_ram.c): montagem de região
+// vazia e com lixo, leitura depois de remontar, desgaste (setores apagados por
+// byte gravado), compactação fora do caminho de gravação e cortes de energia
+// em qualquer ponto de gravações, compactações e da própria montagem. Depois
+// de cada corte cada chave deve ter o último valor confirmado, ou o valor que
+// estava sendo gravado; nenhuma confirmada pode sumir.
+
+#include <string.h>
+#include "flash_kv.h"
+#include "hardware/flash.h"
+#include "test_util.h"
+
+#define KEYS       7            // a última com o tamanho da tabela do servo
+#define LUT_LEN    236
+#define CUTS       20000
+
+typedef struct {
+    bool present;
+    uint16_t len;
+    uint8_t v[FLASH_KV_VALUE_MAX];
+} value_t;
+
+static flash_kv_t kv;
+static uint8_t sectors;
+static uint32_t seed = 2025;
+
+// Estado esperado; globais porque sobrevivem ao longjmp do corte
+static value_t committed[KEYS];
+static value_t inflight;
+static int inflight_key = -1;
+static uint32_t ops, sets;
+
+static void wipe(uint8_t fill) {
+    memset(host_flash, fill, sizeof(host_flash));
+    memset(&host_flash_stats, 0, sizeof(host_flash_stats));
+}
+
+static void random_value(int key, value_t *out) {
+    out->present = true;
+    out->len = key == KEYS - 1 ? LUT_LEN : 1 + test_rand(&seed) % 48;
+    for (int i = 0; i < out->len; i++) out->v[i] = (uint8_t)test_rand(&seed);
+}
+
+static bool same(const value_t *a, const uint8_t *v, int len) {
+    return a->present && a->len == len && memcmp(a->v, v, len) == 0;
+}
+
+// Uma operação qualquer do firmware: gravação (às vezes repetida) ou manutenção
+static void random_op(void) {
+    ops++;
+    if (test_rand(&seed) % 8 == 0) {
+        flash_kv_maintain(&kv);
+        return;
+    }
+    int key = test_rand(&seed) % 16 == 0 ? KEYS - 1 : (int)(test_rand(&seed) % (KEYS - 1));
+    if (committed[key].present && test_rand(&seed) % 10 == 0) {
+        inflight = committed[key];
+    } else {
+        random_value(key, &inflight);
+    }
+    inflight_key = key;
+    bool ok = flash_kv_set(&kv, key, inflight.v, inflight.len);
+    CHECKF(ok, "set da chave %d (%u bytes) falhou sem corte", key, inflight.len);
+    if (ok) committed[key] = inflight;
+    inflight_key = -1;
+    sets++;
+}
+
+// Confere o conteúdo montado contra o esperado e o adota como confirmado
+static int verify(void) {
+    int bad = 0;
+    for (int k = 0; k < KEYS; k++) {
+        uint8_t buf[FLASH_KV_VALUE_MAX];
+        int len = flash_kv_get(&kv, k, buf, sizeof(buf));
+        bool ok;
+        if (len < 0) {
+            ok = !committed[k].present;
+        } else {
+            ok = same(&committed[k], buf, len) || (k == inflight_key && same(&inflight, buf, len));
+        }
+        if (!ok) {
+            if (bad++ < 5) fprintf(stderr, "chave %d: %d bytes inesperados\n", k, len);
+            continue;
+        }
+        committed[k].present = len >= 0;
+        if (len >= 0) {
+            committed[k].len = (uint16_t)len;
+            memcpy(committed[k].v, buf, len);
+        }
+    }
+    inflight_key = -1;
+    return bad;
+}
+
+static void reset_expected(void) {
+    memset(committed, 0, sizeof(committed));
+    inflight_key = -1;
+}
+
+static void test_mount(void) {
+    // Região apagada: vazia, nada a apagar
+    wipe(0xFF);
+    CHECK(!flash_kv_mount(&kv, 0, 1));
+    CHECK(!flash_kv_mount(&kv, 100, 4));
+    CHECK(flash_kv_mount(&kv, 0, 4));
+    CHECK(host_flash_stats.erases == 0);
+    uint8_t buf[8];
+    CHECK(flash_kv_get(&kv, 0, buf, sizeof(buf)) == -1);
+
+    // Lixo (p.ex. a página antiga ou firmware velho): todos os setores apagados
+    wipe(0x5A);
+    CHECK(flash_kv_mount(&kv, 0, 4));
+    CHECK(host_flash_stats.erases == 4);
+    CHECK(flash_kv_get(&kv, 0, buf, sizeof(buf)) == -1);
+
+    // Gravado, remontado e lido de volta; valor igual não grava
+    CHECK(flash_kv_set(&kv, 3, "abc", 3));
+    CHECK(flash_kv_set(&kv, 15, "0123456789", 10));
+    uint32_t programs = host_flash_stats.programs;
+    CHECK(flash_kv_set(&kv, 3, "abc", 3));
+    CHECK(host_flash_stats.programs == programs);
+    CHECK(!flash_kv_set(&kv, FLASH_KV_MAX_KEYS, "x", 1));
+
+    CHECK(flash_kv_mount(&kv, 0, 4));
+    CHECK(flash_kv_get(&kv, 3, buf, sizeof(buf)) == 3 && memcmp(buf, "abc", 3) == 0);
+    CHECK(flash_kv_get(&kv, 15, buf, 4) == 10 && memcmp(buf, "0123", 4) == 0);
+    CHECK(host_flash_stats.bad_programs == 0);
+}
+
+// Cada setor é apagado uma vez a cada ~4 KiB gravados; com manutenção nos
+// intervalos nenhuma gravação apaga setor
+static void test_wear(void) {
+    wipe(0xFF);
+    reset_expected();
+    CHECK(flash_kv_mount(&kv, 0, 4));
+
+    const int n = 20000;
+    uint32_t bytes = 0, erasing_sets = 0;
+    for (int i = 0; i < n; i++) {
+        int key = i % 3;
+        random_value(key, &committed[key]);
+        committed[key].len = 16;
+        bytes += 12 + 16;           // cabeçalho do registro + valor
+        uint32_t before = host_flash_stats.erases;
+        CHECK(flash_kv_set(&kv, key, committed[key].v, 16));
+        if (host_flash_stats.erases != before) erasing_sets++;
+        flash_kv_maintain(&kv);
+        if (i % 1000 == 999) {
+            CHECK(flash_kv_mount(&kv, 0, 4));
+            CHECK(verify() == 0);
+        }
+    }
+    uint32_t per_sector = FLASH_SECTOR_SIZE - 16;
+    printf("desgaste: %d gravações, %u setores apagados (%.1f KiB gravados por apagamento)\n",
+           n, host_flash_stats.erases, bytes / 1024.0 / host_flash_stats.erases);
+    CHECK(host_flash_stats.erases <= bytes / per_sector + 4);
+    CHECK(erasing_sets == 0);
+    CHECK(host_flash_stats.bad_programs == 0);
+}
+
+// Sem manutenção a gravação compacta sozinha quando acabam os setores livres
+static void test_compaction_on_write(void) {
+    wipe(0xFF);
+    reset_expected();
+    CHECK(flash_kv_mount(&kv, 0, 2));
+    for (int i = 0; i < 2000; i++) {
+        int key = i % KEYS;
+        random_value(key, &committed[key]);
+        CHECK(flash_kv_set(&kv, key, committed[key].v, committed[key].len));
+    }
+    CHECK(host_flash_stats.erases > 10);
+    CHECK(flash_kv_mount(&kv, 0, 2));
+    CHECK(verify() == 0);
+}
+
+// Remonta depois de um corte; a montagem também pode ser cortada
+static void remount(void) {
+    for (;;) {
+        jmp_buf jump;
+        host_flash_cut_in(test_rand(&seed) % 4 == 0 ? (long)(test_rand(&seed) % 600) : -1, &jump);
+        if (setjmp(jump) == 0) {
+            CHECK(flash_kv_mount(&kv, 0, sectors));
+            host_flash_cut_in(-1, NULL);
+            return;
+        }
+    }
+}
+
+static void test_power_cuts(uint8_t n_sectors) {
+    sectors = n_sectors;
+    wipe(0xFF);
+    reset_expected();
+    ops = sets = 0;
+    CHECK(flash_kv_mount(&kv, 0, sectors));
+
+    int bad = 0;
+    for (int n = 0; n < CUTS; n++) {
+        jmp_buf jump;
+        host_flash_cut_in(test_rand(&seed) % 3000, &jump);
+        if (setjmp(jump) == 0) {
+            for (;;) random_op();
+        }
+        remount();
+        bad += verify();
+    }
+    printf("%u setores: %d cortes em %u operações (%u gravações, %u apagamentos)\n",
+           sectors, CUTS, ops, sets, host_flash_stats.erases);
+    CHECKF(bad == 0, "%d chaves com valor errado depois de um corte", bad);
+    CHECK(host_flash_stats.cuts >= CUTS);
+    CHECK(host_flash_stats.bad_programs == 0);
+}
+
+int main(void) {
+    test_mount();
+    test_wear();
+    test_compaction_on_write();
+    test_power_cuts(4);
+    test_power_cuts(2);
+    return test_result();
+}
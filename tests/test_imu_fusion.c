@@ -0,0 +1,238 @@
+// imu_fusion: reproduz um trace de amostras brutas do MPU6050 nos dois modos
+// e compara o pitch/roll em ponto fixo com a mesma fusão em float (double),
+// amostra a amostra. Também confere o atan2 por CORDIC e mede o custo por
+// atualização. O trace (tests/data/imu_trace.csv) traz a atitude verdadeira;
+// o erro contra ela é só informativo, o limite vale contra a referência float.
+
+#include <math.h>
+#include <stdlib.h>
+#include "imu_fusion.h"
+#include "test_util.h"
+
+#ifndef TRACE_PATH
+#define TRACE_PATH "data/imu_trace.csv"
+#endif
+
+#define GYRO_RANGE 1            // ±500 °/s, como no firmware
+#define MAX_DIFF_DEG 0.05       // limite |ponto fixo - float|
+#define MAX_ATAN2_DEG 0.005
+
+typedef struct {
+    uint32_t t_us;
+    int16_t accel[3], gyro[3];
+    float pitch, roll;          // verdade
+} sample_t;
+
+static sample_t trace[4096];
+static int trace_len;
+
+static bool load_trace(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) return false;
+    char line[160];
+    while (fgets(line, sizeof(line), f) && trace_len < (int)(sizeof(trace) / sizeof(trace[0]))) {
+        if (line[0] == '#') continue;
+        sample_t *s = &trace[trace_len];
+        int a[3], g[3];
+        unsigned long t;
+        if (sscanf(line, "%lu,%d,%d,%d,%d,%d,%d,%f,%f", &t, &a[0], &a[1], &a[2],
+                   &g[0], &g[1], &g[2], &s->pitch, &s->roll) != 9) continue;
+        s->t_us = (uint32_t)t;
+        for (int i = 0; i < 3; i++) {
+            s->accel[i] = (int16_t)a[i];
+            s->gyro[i] = (int16_t)g[i];
+        }
+        trace_len++;
+    }
+    fclose(f);
+    return trace_len > 0;
+}
+
+// ==== Referência em float: mesmas equações, ganhos e tratamento de dt ====
+#define RAD2DEG (180.0 / M_PI)
+
+typedef struct {
+    imu_fusion_mode_t mode;
+    double pitch, roll;         // graus
+    double q[4];
+    uint32_t last_us, start_us;
+    bool initialized;
+} ref_t;
+
+static double wrap180(double a) {
+    if (a > 180) a -= 360;
+    else if (a <= -180) a += 360;
+    return a;
+}
+
+static double gyro_dps(int16_t raw) {
+    return raw * (250.0 * (1 << GYRO_RANGE)) / 32768.0;
+}
+
+static void ref_accel_angles(const int16_t a[3], double *pitch, double *roll) {
+    *roll = atan2(a[1], a[2]) * RAD2DEG;
+    *pitch = atan2(-a[0], sqrt((double)a[1] * a[1] + (double)a[2] * a[2])) * RAD2DEG;
+}
+
+static void ref_complementary(ref_t *r, const sample_t *s, double dt) {
+    double pitch_acc, roll_acc, k = 1 - 0.98;
+    ref_accel_angles(s->accel, &pitch_acc, &roll_acc);
+    r->pitch += gyro_dps(s->gyro[1]) * dt;
+    r->roll = wrap180(r->roll + gyro_dps(s->gyro[0]) * dt);
+    r->pitch += wrap180(pitch_acc - r->pitch) * k;
+    r->roll = wrap180(r->roll + wrap180(roll_acc - r->roll) * k);
+}
+
+static void normalize(double *v, int n) {
+    double s = 0;
+    for (int i = 0; i < n; i++) s += v[i] * v[i];
+    if (s == 0) return;
+    s = 1 / sqrt(s);
+    for (int i = 0; i < n; i++) v[i] *= s;
+}
+
+static void ref_madgwick(ref_t *r, const sample_t *s, double dt, bool warmup) {
+    double q0 = r->q[0], q1 = r->q[1], q2 = r->q[2], q3 = r->q[3];
+    double gx = gyro_dps(s->gyro[0]) / RAD2DEG;
+    double gy = gyro_dps(s->gyro[1]) / RAD2DEG;
+    double gz = gyro_dps(s->gyro[2]) / RAD2DEG;
+
+    double qd[4] = {
+        0.5 * (-q1 * gx - q2 * gy - q3 * gz),
+        0.5 * (q0 * gx + q2 * gz - q3 * gy),
+        0.5 * (q0 * gy - q1 * gz + q3 * gx),
+        0.5 * (q0 * gz + q1 * gy - q2 * gx),
+    };
+
+    double a[3] = { s->accel[0], s->accel[1], s->accel[2] };
+    normalize(a, 3);
+    double ax = a[0], ay = a[1], az = a[2];
+    double q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+    double g[4] = {
+        4 * q0 * q2q2 + 2 * q2 * ax + 4 * q0 * q1q1 - 2 * q1 * ay,
+        4 * q1 * q3q3 - 2 * q3 * ax + 4 * q0q0 * q1 - 2 * q0 * ay - 4 * q1 + 8 * q1 * q1q1 +
+            8 * q1 * q2q2 + 4 * q1 * az,
+        4 * q0q0 * q2 + 2 * q0 * ax + 4 * q2 * q3q3 - 2 * q3 * ay - 4 * q2 + 8 * q2 * q1q1 +
+            8 * q2 * q2q2 + 4 * q2 * az,
+        4 * q1q1 * q3 - 2 * q1 * ax + 4 * q2q2 * q3 - 2 * q2 * ay,
+    };
+    normalize(g, 4);
+    double beta = warmup ? 1.0 : 0.1;
+    for (int i = 0; i < 4; i++) r->q[i] += (qd[i] - beta * g[i]) * dt;
+    normalize(r->q, 4);
+
+    q0 = r->q[0]; q1 = r->q[1]; q2 = r->q[2]; q3 = r->q[3];
+    double sinp = 2 * (q0 * q2 - q1 * q3);
+    if (sinp > 1) sinp = 1;
+    if (sinp < -1) sinp = -1;
+    r->pitch = asin(sinp) * RAD2DEG;
+    r->roll = atan2(2 * (q0 * q1 + q2 * q3), 1 - 2 * (q1 * q1 + q2 * q2)) * RAD2DEG;
+}
+
+static void ref_update(ref_t *r, const sample_t *s) {
+    if (!r->initialized) {
+        ref_accel_angles(s->accel, &r->pitch, &r->roll);
+        r->q[0] = 1;
+        r->q[1] = r->q[2] = r->q[3] = 0;
+        r->last_us = r->start_us = s->t_us;
+        r->initialized = true;
+        return;
+    }
+    uint32_t dt_us = s->t_us - r->last_us;
+    r->last_us = s->t_us;
+    bool warmup = r->last_us - r->start_us < 1000000u;
+    if (dt_us > 100000u) dt_us = 100000u;
+
+    if (r->mode == IMU_FUSION_MADGWICK) ref_madgwick(r, s, dt_us * 1e-6, warmup);
+    else ref_complementary(r, s, dt_us * 1e-6);
+}
+
+// ==== Testes ====
+static double q16_deg(q16_t a) {
+    return a / 65536.0;
+}
+
+static void test_atan2(void) {
+    double worst = 0;
+    uint32_t seed = 99;
+    for (int i = 0; i < 100000; i++) {
+        // |x|, |y| < 2^30: o módulo ainda cabe em int32
+        int32_t y = (int32_t)test_rand(&seed) >> (1 + test_rand(&seed) % 31);
+        int32_t x = (int32_t)test_rand(&seed) >> (1 + test_rand(&seed) % 31);
+        if (x == 0 && y == 0) continue;
+        int32_t mag;
+        double got = q16_deg(imu_fusion_atan2(y, x, &mag));
+        double err = fabs(wrap180(got - atan2(y, x) * RAD2DEG));
+        if (err > worst) worst = err;
+        double m = hypot(x, y);
+        CHECKF(fabs(mag - m) <= m * 1e-3 + 2, "mag(%d, %d) = %d, esperado %.0f", y, x, mag, m);
+    }
+    printf("atan2 CORDIC: erro máximo %.4f graus\n", worst);
+    CHECK(worst < MAX_ATAN2_DEG);
+}
+
+static void replay(imu_fusion_mode_t mode, const char *name) {
+    imu_fusion_t f;
+    imu_fusion_init(&f, mode, GYRO_RANGE);
+    ref_t r = { .mode = mode };
+
+    double worst = 0, sq_truth = 0;
+    int worst_at = 0;
+    for (int i = 0; i < trace_len; i++) {
+        const sample_t *s = &trace[i];
+        imu_fusion_update(&f, s->accel, s->gyro, s->t_us);
+        ref_update(&r, s);
+
+        double dp = fabs(q16_deg(f.pitch) - r.pitch);
+        double dr = fabs(wrap180(q16_deg(f.roll) - r.roll));
+        if (dp > worst) { worst = dp; worst_at = i; }
+        if (dr > worst) { worst = dr; worst_at = i; }
+
+        double ep = q16_deg(f.pitch) - s->pitch, er = wrap180(q16_deg(f.roll) - s->roll);
+        sq_truth += ep * ep + er * er;
+    }
+    printf("%s: |fixo - float| máx %.3f graus (amostra %d), RMS contra a verdade %.2f graus\n",
+           name, worst, worst_at, sqrt(sq_truth / (2.0 * trace_len)));
+    CHECKF(worst < MAX_DIFF_DEG, "%s: %.3f graus", name, worst);
+}
+
+static void bench(imu_fusion_mode_t mode, const char *name) {
+    const int passes = 200;
+    imu_fusion_t f;
+    ref_t r = { .mode = mode };
+    volatile int32_t sink = 0;   // impede o compilador de descartar os laços
+
+    uint64_t t0 = test_now_ns();
+    for (int p = 0; p < passes; p++) {
+        imu_fusion_init(&f, mode, GYRO_RANGE);
+        for (int i = 0; i < trace_len; i++) {
+            imu_fusion_update(&f, trace[i].accel, trace[i].gyro, trace[i].t_us);
+        }
+        sink += f.pitch;
+    }
+    uint64_t t1 = test_now_ns();
+    for (int p = 0; p < passes; p++) {
+        r.initialized = false;
+        for (int i = 0; i < trace_len; i++) ref_update(&r, &trace[i]);
+        sink += (int32_t)r.pitch;
+    }
+    uint64_t t2 = test_now_ns();
+
+    double n = (double)passes * trace_len;
+    // No host há FPU; no Cortex-M0+ o double seria emulado em software
+    printf("%s: %.0f ns por atualização em ponto fixo, %.0f ns em double (host)\n",
+           name, (t1 - t0) / n, (t2 - t1) / n);
+}
+
+int main(void) {
+    if (!load_trace(TRACE_PATH)) {
+        fprintf(stderr, "trace não encontrado: %s\n", TRACE_PATH);
+        return 1;
+    }
+    test_atan2();
+    replay(IMU_FUSION_COMPLEMENTARY, "complementar");
+    replay(IMU_FUSION_MADGWICK, "Madgwick");
+    bench(IMU_FUSION_COMPLEMENTARY, "complementar");
+    bench(IMU_FUSION_MADGWICK, "Madgwick");
+    return test_result();
+}
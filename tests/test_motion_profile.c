@@ -0,0 +1,158 @@
+// motion_profile: simula o perfil a 50 Hz (como o timer do servo_velocity) com
+// os limites do BH1750_Lux e confere, para vários deslocamentos, que o movimento
+// não passa do alvo nem inverte o sentido, respeita velocidade, aceleração e
+// jerk, e assenta perto do tempo mínimo teórico. Também troca o alvo no meio
+// do movimento e mede o custo de cada passo.
+
+#include <math.h>
+#include "motion_profile.h"
+#include "test_util.h"
+
+#define DT 0.02f                // LOOP_MS do servo_velocity
+#define MAX_STEPS 2000          // 40 s simulados
+#define MAX_OVERSHOOT 0.01      // graus
+#define SETTLE_SLACK 1.20       // assentamento <= 1,2 x mínimo teórico + 3 passos
+
+static const motion_limits_t s_curve = { 180.0f, 720.0f, 3600.0f };
+static const motion_limits_t trapezoid = { 180.0f, 720.0f, 0.0f };
+
+// Tempo mínimo de repouso a repouso para a distância d com os limites dados
+static double accel_time(const motion_limits_t *lim, double v) {
+    double a = lim->accel_max, j = lim->jerk_max;
+    if (j <= 0) return v / a;
+    if (v * j < a * a) return 2 * sqrt(v / j);  // a aceleração não chega a a_max
+    return v / a + a / j;
+}
+
+static double min_time(const motion_limits_t *lim, double d) {
+    double v = lim->vel_max;
+    double ta = accel_time(lim, v);
+    if (d >= v * ta) return 2 * ta + (d - v * ta) / v;
+    // Sem trecho de cruzeiro: procura a velocidade de pico que cobre d
+    double lo = 0, hi = v;
+    for (int i = 0; i < 60; i++) {
+        double mid = 0.5 * (lo + hi);
+        if (mid * accel_time(lim, mid) < d) lo = mid; else hi = mid;
+    }
+    return 2 * accel_time(lim, lo);
+}
+
+typedef struct {
+    int steps;                  // passos até settled
+    double overshoot;           // graus além do alvo
+    bool reversed;              // velocidade contra o alvo
+    double vel, accel, jerk;    // máximos observados
+} run_t;
+
+static void observe(run_t *r, const motion_profile_t *mp, float prev_accel) {
+    if (fabsf(mp->vel) > r->vel) r->vel = fabsf(mp->vel);
+    if (fabsf(mp->accel) > r->accel) r->accel = fabsf(mp->accel);
+    double j = fabsf(mp->accel - prev_accel) / DT;
+    if (j > r->jerk) r->jerk = j;
+}
+
+// Move de from até to partindo do repouso
+static run_t simulate(const motion_limits_t *lim, float from, float to) {
+    motion_profile_t mp;
+    motion_profile_init(&mp, lim, DT, from);
+    motion_profile_set_target(&mp, to);
+
+    run_t r = { 0 };
+    float dir = to >= from ? 1.0f : -1.0f;
+    while (!mp.settled && r.steps < MAX_STEPS) {
+        float prev_accel = mp.accel;
+        float vel = motion_profile_step(&mp);
+        r.steps++;
+        observe(&r, &mp, prev_accel);
+        if (vel * dir < -1e-3f) r.reversed = true;
+        double over = (mp.pos - to) * dir;
+        if (over > r.overshoot) r.overshoot = over;
+    }
+    CHECK(mp.settled && mp.pos == to && mp.vel == 0);
+    return r;
+}
+
+static void check_limits(const motion_limits_t *lim, const run_t *r, const char *what) {
+    CHECKF(r->vel <= lim->vel_max * 1.001, "%s: vel %.1f", what, r->vel);
+    CHECKF(r->accel <= lim->accel_max * 1.001, "%s: accel %.1f", what, r->accel);
+    // Sem limite de jerk a aceleração pode saltar de -a_max a a_max num passo
+    double jmax = lim->jerk_max > 0 ? lim->jerk_max : 2 * lim->accel_max / DT;
+    CHECKF(r->jerk <= jmax * 1.001, "%s: jerk %.0f", what, r->jerk);
+}
+
+static void test_moves(const motion_limits_t *lim, const char *name) {
+    static const float moves[][2] = {
+        { 0, 180 }, { 180, 0 }, { 0, 90 }, { 10, 40 }, { 0, 5 },
+        { 90, -30 }, { 0, 1 }, { 45, 44.7f }, { -120, 240 },
+    };
+    for (unsigned i = 0; i < sizeof(moves) / sizeof(moves[0]); i++) {
+        float from = moves[i][0], to = moves[i][1];
+        run_t r = simulate(lim, from, to);
+        double t = r.steps * DT, t_min = min_time(lim, fabs(to - from));
+        char what[48];
+        snprintf(what, sizeof(what), "%s %g -> %g", name, from, to);
+
+        printf("%s: assenta em %.2f s (mínimo %.2f s), passa %.4f graus\n", what, t, t_min, r.overshoot);
+        CHECKF(r.overshoot <= MAX_OVERSHOOT, "%s: passou %.4f graus do alvo", what, r.overshoot);
+        CHECKF(!r.reversed, "%s: inverteu o sentido", what);
+        CHECKF(t <= t_min * SETTLE_SLACK + 3 * DT, "%s: %.2f s, mínimo %.2f s", what, t, t_min);
+        check_limits(lim, &r, what);
+    }
+}
+
+// Alvo novo no meio do movimento: parte do estado atual sem violar os limites
+// e assenta no novo alvo sem passar dele
+static void test_retarget(const motion_limits_t *lim, const char *name) {
+    motion_profile_t mp;
+    motion_profile_init(&mp, lim, DT, 0);
+    motion_profile_set_target(&mp, 180);
+    run_t r = { 0 };
+    for (int i = 0; i < 40; i++) {      // 0,8 s: em plena velocidade
+        float prev_accel = mp.accel;
+        motion_profile_step(&mp);
+        observe(&r, &mp, prev_accel);
+    }
+    float turn = mp.pos;
+    CHECK(mp.vel > 0);
+    motion_profile_set_target(&mp, 20);
+
+    double peak = turn;
+    int steps = 0;
+    while (!mp.settled && steps++ < MAX_STEPS) {
+        float prev_accel = mp.accel;
+        motion_profile_step(&mp);
+        observe(&r, &mp, prev_accel);
+        if (mp.pos > peak) peak = mp.pos;
+        CHECKF(mp.pos >= 20 - MAX_OVERSHOOT, "%s: passou do alvo novo (%.3f)", name, mp.pos);
+    }
+    CHECK(mp.settled && mp.pos == 20);
+    // Freia a partir de onde estava: o pico é só a distância de parada
+    printf("%s, retorno em %.1f graus: pico %.1f, assenta %.2f s depois\n", name, turn, peak, steps * DT);
+    check_limits(lim, &r, name);
+}
+
+static void bench(const motion_limits_t *lim, const char *name) {
+    motion_profile_t mp;
+    int steps = 0;
+    uint64_t t0 = test_now_ns();
+    for (int k = 0; k < 2000; k++) {
+        motion_profile_init(&mp, lim, DT, 0);
+        motion_profile_set_target(&mp, (k & 1) ? 180 : 30);
+        while (!mp.settled) {
+            motion_profile_step(&mp);
+            steps++;
+        }
+    }
+    uint64_t t1 = test_now_ns();
+    printf("%s: %.0f ns por passo (host)\n", name, (double)(t1 - t0) / steps);
+}
+
+int main(void) {
+    test_moves(&s_curve, "curva S");
+    test_moves(&trapezoid, "trapézio");
+    test_retarget(&s_curve, "curva S");
+    test_retarget(&trapezoid, "trapézio");
+    bench(&s_curve, "curva S");
+    bench(&trapezoid, "trapézio");
+    return test_result();
+}
@@ -0,0 +1,147 @@
+// Amostragem adaptativa do stream do MPU6050 sobre um banco de registradores
+// simulado: o boot fica em repouso, um evento de movimento sobe a taxa na
+// próxima chamada, eventos seguidos mantêm o modo ativo e só quiet_ms sem
+// eventos voltam ao repouso. Confere a taxa gravada em SMPLRT_DIV, a
+// contabilidade de tempo e amostras por modo e o relógio de 32 bits dando a
+// volta. A IRQ é simulada escrevendo direto nos contadores do stream.
+
+#include <string.h>
+#include "mpu6050_i2c.h"
+#include "test_util.h"
+
+uint64_t host_time_us = 5000000;
+
+#define IDLE_HZ   10
+#define ACTIVE_HZ 100
+#define QUIET_MS  3000
+#define STEP_MS   100       // intervalo entre chamadas de mpu6050_adaptive_update
+
+// ==== Mock do barramento: só as escritas de registrador importam ====
+struct i2c_inst { int index; };
+static struct i2c_inst bus0 = { 0 }, bus1 = { 1 };
+i2c_inst_t *const host_i2c0 = &bus0;
+i2c_inst_t *const host_i2c1 = &bus1;
+
+static uint8_t regs[128];
+static uint32_t rate_writes;    // escritas que passaram por SMPLRT_DIV
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    (void)i2c;
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)nostop;
+    CHECK(i2c == i2c0 && addr == MPU6050_ADDR);
+    if (len > 1 && src[0] == 0x19) rate_writes++;
+    for (size_t i = 1; i < len; i++) regs[(src[0] + i - 1) & 0x7F] = src[i];
+    return (int)len;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    (void)i2c; (void)addr; (void)nostop;
+    memset(dst, 0, len);
+    return (int)len;
+}
+
+// ==== Stream simulado ====
+static mpu6050_sample_t ring_buf[16];
+static spsc_ring_t ring;
+static mpu6050_stream_t st;
+static mpu6050_adaptive_t ad;
+
+static uint16_t rate_hz(void) {
+    return 1000 / (regs[0x19] + 1);     // DLPF ativo: base de 1 kHz
+}
+
+// Avança o tempo em passos do loop, com as amostras chegando na taxa atual;
+// conta as trocas de modo
+static int run(uint32_t ms) {
+    int changes = 0;
+    for (uint32_t t = 0; t < ms; t += STEP_MS) {
+        sleep_ms(STEP_MS);
+        st.samples += STEP_MS * rate_hz() / 1000;
+        if (mpu6050_adaptive_update(&ad, &st, time_us_32())) changes++;
+    }
+    return changes;
+}
+
+static void motion(void) {
+    st.motion_events++;
+    st.last_motion_us = time_us_32();
+}
+
+static void start(void) {
+    memset(regs, 0, sizeof(regs));
+    spsc_ring_init(&ring, ring_buf, sizeof(mpu6050_sample_t), 16);
+    CHECK(mpu6050_stream_start(&st, &ring, 16, IDLE_HZ, 3, MPU6050_ACCEL | MPU6050_GYRO));
+    mpu6050_adaptive_init(&ad, IDLE_HZ, ACTIVE_HZ, QUIET_MS, time_us_32());
+    rate_writes = 0;
+}
+
+// Sem movimento desde o boot: nenhuma troca, taxa de repouso
+static void test_boot_idle(void) {
+    start();
+    CHECK(rate_hz() == IDLE_HZ);
+    CHECKF(run(10000) == 0, "trocou de modo sem movimento (%u trocas)", ad.switches);
+    CHECK(!ad.active && ad.switches == 0);
+    CHECK(rate_writes == 0);
+    CHECK(rate_hz() == IDLE_HZ);
+    CHECK(ad.time_us[1] == 0 && ad.samples[1] == 0);
+}
+
+static void test_switching(void) {
+    start();
+    run(1000);
+
+    // Um evento: ativo na próxima chamada, uma única troca
+    motion();
+    CHECK(run(STEP_MS) == 1);
+    CHECK(ad.active && rate_hz() == ACTIVE_HZ);
+    CHECK(rate_writes == 1);
+
+    // Eventos a cada 2 s (menos que quiet_ms): continua ativo
+    for (int i = 0; i < 5; i++) {
+        CHECK(run(2000) == 0);
+        motion();
+    }
+    CHECK(ad.active && ad.switches == 1);
+
+    // Sem eventos: continua ativo até quiet_ms depois do último, então repouso
+    uint32_t last = st.last_motion_us;
+    CHECK(run(QUIET_MS - STEP_MS) == 0);
+    CHECK(ad.active);
+    CHECK(run(STEP_MS) == 1);
+    CHECK(!ad.active && rate_hz() == IDLE_HZ);
+    CHECK(time_us_32() - last >= QUIET_MS * 1000u);
+    CHECK(ad.switches == 2 && rate_writes == 2);
+
+    // Tempo e amostras somados por modo
+    uint64_t total = ad.time_us[0] + ad.time_us[1];
+    CHECK(total == (uint64_t)(1000 + STEP_MS + 5 * 2000 + QUIET_MS) * 1000);
+    CHECK(ad.samples[0] + ad.samples[1] == st.samples);
+    CHECK(ad.samples[1] > ad.samples[0]);
+    printf("repouso %llu ms/%u amostras, ativo %llu ms/%u amostras, %u trocas\n",
+           (unsigned long long)(ad.time_us[0] / 1000), ad.samples[0],
+           (unsigned long long)(ad.time_us[1] / 1000), ad.samples[1], ad.switches);
+}
+
+// ~71 min sem movimento: time_us_32() dá a volta e now - last_motion_us fica
+// pequeno de novo, mas sem evento novo o stream continua em repouso
+static void test_wraparound(void) {
+    start();
+    motion();
+    run(QUIET_MS + STEP_MS);
+    CHECK(!ad.active && ad.switches == 2);
+
+    host_time_us += (1ull << 32) - (QUIET_MS + STEP_MS) * 1000ull;
+    CHECK(run(QUIET_MS) == 0);
+    CHECK(!ad.active && rate_hz() == IDLE_HZ);
+}
+
+int main(void) {
+    test_boot_idle();
+    test_switching();
+    test_wraparound();
+    return test_result();
+}
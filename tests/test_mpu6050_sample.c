@@ -0,0 +1,149 @@
+// mpu6050_read_sample sobre um banco de registradores simulado: cada
+// combinação de campos deve sair de uma única transação (endereço + leitura
+// com repeated start) começando no registrador certo, com os campos
+// decodificados em big-endian e os demais intocados.
+
+#include <string.h>
+#include "mpu6050_i2c.h"
+#include "test_util.h"
+
+uint64_t host_time_us = 123456;
+
+// ==== Mock do barramento: MPU6050 em 0x68 com autoincremento ====
+struct i2c_inst { int index; };
+static struct i2c_inst bus0 = { 0 }, bus1 = { 1 };
+i2c_inst_t *const host_i2c0 = &bus0;
+i2c_inst_t *const host_i2c1 = &bus1;
+
+static uint8_t regs[128];
+static uint8_t reg_ptr;
+static bool nack;
+
+static struct {
+    uint32_t transactions;  // START..STOP (repeated start não conta)
+    uint32_t writes, reads;
+    uint8_t read_start;     // registrador da última leitura
+    size_t read_len;
+    bool open;              // transação sem STOP em andamento
+} bus;
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    (void)i2c;
+    return baudrate;
+}
+
+static void bus_end(bool nostop) {
+    bus.open = nostop;
+    if (!nostop) bus.transactions++;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    CHECK(i2c == i2c0);
+    bus.writes++;
+    if (nack || addr != MPU6050_ADDR) {
+        bus_end(false);
+        return PICO_ERROR_GENERIC;
+    }
+    if (len) {
+        reg_ptr = src[0] & 0x7F;
+        for (size_t i = 1; i < len; i++) regs[(reg_ptr++) & 0x7F] = src[i];
+    }
+    bus_end(nostop);
+    return (int)len;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    CHECK(i2c == i2c0);
+    bus.reads++;
+    if (nack || addr != MPU6050_ADDR) {
+        bus_end(false);
+        return PICO_ERROR_GENERIC;
+    }
+    bus.read_start = reg_ptr;
+    bus.read_len = len;
+    for (size_t i = 0; i < len; i++) dst[i] = regs[(reg_ptr++) & 0x7F];
+    bus_end(nostop);
+    return (int)len;
+}
+
+// ==== Valores nos registradores de dados 0x3B..0x48 ====
+static const int16_t accel_ref[3] = { -16384, 1234, 32767 };
+static const int16_t temp_ref = -5210;
+static const int16_t gyro_ref[3] = { -32768, -1, 4096 };
+
+static void put16(uint8_t reg, int16_t v) {
+    regs[reg] = (uint8_t)((uint16_t)v >> 8);
+    regs[reg + 1] = (uint8_t)v;
+}
+
+static void load_regs(void) {
+    memset(regs, 0xEE, sizeof(regs));
+    regs[0x3A] = 0x01;              // INT_STATUS (não deve ser lido aqui)
+    for (int i = 0; i < 3; i++) put16(0x3B + 2 * i, accel_ref[i]);
+    put16(0x41, temp_ref);
+    for (int i = 0; i < 3; i++) put16(0x43 + 2 * i, gyro_ref[i]);
+}
+
+// Faixa contígua esperada para cada máscara: campos entre o primeiro e o último
+// pedido também vêm (e são marcados como válidos)
+static void expected(uint8_t fields, uint8_t *start, size_t *len, uint8_t *covered) {
+    uint8_t first = (fields & MPU6050_ACCEL) ? 0x3B : (fields & MPU6050_TEMP) ? 0x41 : 0x43;
+    uint8_t end = (fields & MPU6050_GYRO) ? 0x49 : (fields & MPU6050_TEMP) ? 0x43 : 0x41;
+    *start = first;
+    *len = end - first;
+    *covered = (first <= 0x3B && end >= 0x41 ? MPU6050_ACCEL : 0) |
+               (first <= 0x41 && end >= 0x43 ? MPU6050_TEMP : 0) |
+               (first <= 0x43 && end >= 0x49 ? MPU6050_GYRO : 0);
+}
+
+static void test_masks(void) {
+    for (uint8_t fields = 1; fields <= MPU6050_ALL; fields++) {
+        uint8_t start, covered;
+        size_t len;
+        expected(fields, &start, &len, &covered);
+
+        load_regs();
+        memset(&bus, 0, sizeof(bus));
+        mpu6050_sample_t s;
+        memset(&s, 0x5A, sizeof(s));
+        host_time_us += 1000;
+
+        CHECKF(mpu6050_read_sample(&s, fields), "campos %u", fields);
+        CHECKF(bus.transactions == 1 && bus.writes == 1 && bus.reads == 1,
+               "campos %u: %u transações, %u escritas, %u leituras", fields,
+               bus.transactions, bus.writes, bus.reads);
+        CHECK(!bus.open);
+        CHECKF(bus.read_start == start && bus.read_len == len,
+               "campos %u: leu 0x%02X+%zu, esperado 0x%02X+%zu", fields,
+               bus.read_start, bus.read_len, start, len);
+        CHECKF(s.fields == covered, "campos %u: fields %u, esperado %u", fields, s.fields, covered);
+        CHECK(s.timestamp_us == (uint32_t)host_time_us);
+
+        for (int i = 0; i < 3; i++) {
+            int16_t untouched = (int16_t)0x5A5A;
+            CHECKF(s.accel[i] == ((covered & MPU6050_ACCEL) ? accel_ref[i] : untouched),
+                   "campos %u: accel[%d] = %d", fields, i, s.accel[i]);
+            CHECKF(s.gyro[i] == ((covered & MPU6050_GYRO) ? gyro_ref[i] : untouched),
+                   "campos %u: gyro[%d] = %d", fields, i, s.gyro[i]);
+        }
+        CHECKF(s.temp == ((covered & MPU6050_TEMP) ? temp_ref : (int16_t)0x5A5A),
+               "campos %u: temp = %d", fields, s.temp);
+    }
+}
+
+static void test_bus_error(void) {
+    load_regs();
+    memset(&bus, 0, sizeof(bus));
+    nack = true;
+    mpu6050_sample_t s;
+    CHECK(!mpu6050_read_sample(&s, MPU6050_ALL));
+    CHECK(bus.reads == 0);      // endereço sem ACK: não tenta ler
+    CHECK(!bus.open);
+    nack = false;
+}
+
+int main(void) {
+    test_masks();
+    test_bus_error();
+    return test_result();
+}
@@ -0,0 +1,123 @@
+// seqlock: a sequência de versões de um escritor e as decisões do leitor
+// (repetir se a cópia cruzou uma escrita), e um escritor e um leitor em threads
+// separadas (como core1 -> core0) com um dado redundante: nenhuma cópia aceita
+// pode misturar duas publicações. Mede quantas leituras precisaram repetir.
+
+#include <pthread.h>
+#include <sched.h>
+#include "seqlock.h"
+#include "test_util.h"
+
+static void test_sequence(void) {
+    seqlock_t s;
+    seqlock_init(&s);
+    CHECK(seqlock_version(&s) == 0);
+
+    // Leitura sem escrita no meio: aceita
+    uint32_t seq = seqlock_read_begin(&s);
+    CHECK(!seqlock_read_retry(&s, seq));
+
+    // Escrita em andamento no início da leitura: repete
+    seqlock_write_begin(&s);
+    seq = seqlock_read_begin(&s);
+    CHECK(seq & 1);
+    CHECK(seqlock_read_retry(&s, seq));
+    seqlock_write_end(&s);
+    CHECK(seqlock_version(&s) == 1);
+
+    // Escrita completa durante a cópia: repete
+    seq = seqlock_read_begin(&s);
+    seqlock_write_begin(&s);
+    seqlock_write_end(&s);
+    CHECK(seqlock_read_retry(&s, seq));
+    CHECK(seqlock_version(&s) == 2);
+
+    // Contador dando a volta
+    s.seq = UINT32_MAX - 1;
+    seq = seqlock_read_begin(&s);
+    seqlock_write_begin(&s);
+    seqlock_write_end(&s);
+    CHECK(s.seq == 0);
+    CHECK(seqlock_read_retry(&s, seq));
+}
+
+// Snapshot com conteúdo redundante, maior que uma palavra: uma cópia rasgada
+// não confere
+#define WORDS 8
+
+static seqlock_t lock;
+static volatile uint32_t snapshot[WORDS];
+static volatile bool writer_done;
+
+#define WRITES 2000000u
+
+static uint32_t pattern(uint32_t v, int i) {
+    return v * (i + 1) ^ (i & 1 ? ~0u : 0);
+}
+
+static void *writer(void *arg) {
+    (void)arg;
+    uint32_t data[WORDS];
+    for (uint32_t v = 1; v <= WRITES; v++) {
+        for (int i = 0; i < WORDS; i++) data[i] = pattern(v, i);
+        seqlock_write_begin(&lock);
+        for (int i = 0; i < WORDS; i++) {
+            snapshot[i] = data[i];
+            // De vez em quando cede a CPU no meio da cópia: com um só núcleo é
+            // assim que o leitor chega a ver uma escrita pela metade
+            if (i == WORDS / 2 && (v & 255) == 0) sched_yield();
+        }
+        seqlock_write_end(&lock);
+        if ((v & 255) == 128) sched_yield();
+    }
+    writer_done = true;
+    return NULL;
+}
+
+static bool consistent(const uint32_t *d) {
+    for (int i = 0; i < WORDS; i++) {
+        if (d[i] != pattern(d[0], i)) return false;
+    }
+    return true;
+}
+
+static void test_threads(void) {
+    seqlock_init(&lock);
+    for (int i = 0; i < WORDS; i++) snapshot[i] = pattern(0, i);   // publicação inicial
+    writer_done = false;
+
+    pthread_t t;
+    pthread_create(&t, NULL, writer, NULL);
+
+    uint32_t reads = 0, retries = 0, torn = 0, backwards = 0, last = 0;
+    while (!writer_done) {
+        uint32_t copy[WORDS], seq;
+        for (;;) {
+            seq = seqlock_read_begin(&lock);
+            for (int i = 0; i < WORDS; i++) copy[i] = snapshot[i];
+            if (!seqlock_read_retry(&lock, seq)) break;
+            retries++;
+            if ((retries & 255) == 0) sched_yield();
+        }
+        reads++;
+        if ((reads & 4095) == 0) sched_yield();
+        if (!consistent(copy)) torn++;
+        if (copy[0] < last) backwards++;
+        last = copy[0];
+    }
+    pthread_join(t, NULL);
+
+    printf("2 threads: %u leituras, %u repetidas (%.2f%%), %u escritas\n",
+           reads, retries, 100.0 * retries / (reads + retries), WRITES);
+    CHECKF(torn == 0, "%u cópias rasgadas aceitas", torn);
+    CHECK(backwards == 0);
+    CHECK(seqlock_version(&lock) == WRITES);
+    CHECK(reads > WRITES / 1024);
+    CHECK(retries > 0);         // o leitor chegou a cruzar escritas
+}
+
+int main(void) {
+    test_sequence();
+    test_threads();
+    return test_result();
+}
@@ -0,0 +1,165 @@
+// spsc_ring: cheio/vazio, ordem FIFO com os índices e os contadores de 32 bits
+// dando a volta, e um produtor e um consumidor em threads separadas (como IRQ
+// -> loop ou core1 -> core0). Mede a vazão nos dois casos.
+
+#include <pthread.h>
+#include <sched.h>
+#include "spsc_ring.h"
+#include "test_util.h"
+
+static void test_init(void) {
+    uint32_t buf[8];
+    spsc_ring_t r;
+    CHECK(!spsc_ring_init(&r, buf, sizeof(uint32_t), 0));
+    CHECK(!spsc_ring_init(&r, buf, sizeof(uint32_t), 6));
+    CHECK(spsc_ring_init(&r, buf, sizeof(uint32_t), 8));
+    CHECK(spsc_ring_capacity(&r) == 8);
+}
+
+static void test_empty_full(void) {
+    uint32_t buf[8], v;
+    spsc_ring_t r;
+    spsc_ring_init(&r, buf, sizeof(uint32_t), 8);
+
+    CHECK(spsc_ring_count(&r) == 0);
+    CHECK(spsc_ring_free(&r) == 8);
+    CHECK(spsc_ring_peek(&r) == NULL);
+    CHECK(!spsc_ring_pop(&r, &v));
+
+    for (v = 0; v < 8; v++) CHECK(spsc_ring_push(&r, &v));
+    CHECK(spsc_ring_count(&r) == 8);
+    CHECK(spsc_ring_free(&r) == 0);
+    CHECK(spsc_ring_claim(&r) == NULL);
+
+    // Cheio: o novo é descartado e contado; os antigos ficam
+    v = 99;
+    CHECK(!spsc_ring_push(&r, &v));
+    CHECK(r.overruns == 1);
+    for (uint32_t i = 0; i < 8; i++) {
+        CHECK(spsc_ring_pop(&r, &v));
+        CHECK(v == i);
+    }
+    CHECK(!spsc_ring_pop(&r, &v));
+    CHECK(spsc_ring_count(&r) == 0);
+}
+
+// Lotes de tamanhos variados: o índice dá a volta no buffer a cada poucos lotes
+// e os contadores começam perto de UINT32_MAX para atravessar o estouro
+static void test_wraparound(void) {
+    uint32_t buf[16], v;
+    spsc_ring_t r;
+    spsc_ring_init(&r, buf, sizeof(uint32_t), 16);
+    r.head = r.tail = UINT32_MAX - 40;
+
+    uint32_t next_in = 0, next_out = 0, seed = 7;
+    int errors = 0;
+    for (int round = 0; round < 1000; round++) {
+        uint32_t n = test_rand(&seed) % 17;
+        for (uint32_t i = 0; i < n; i++) {
+            bool full = spsc_ring_count(&r) == 16;
+            if (spsc_ring_push(&r, &next_in) == full) errors++;
+            if (!full) next_in++;
+        }
+        uint32_t m = test_rand(&seed) % 17;
+        for (uint32_t i = 0; i < m; i++) {
+            bool empty = next_out == next_in;
+            if (spsc_ring_pop(&r, &v) == empty) errors++;
+            if (!empty && v != next_out++) errors++;
+        }
+        if (spsc_ring_count(&r) != next_in - next_out) errors++;
+    }
+    CHECKF(errors == 0, "%d erros", errors);
+    CHECK(r.head < 1000u * 16);     // atravessou o estouro dos contadores
+    CHECK(r.overruns > 0);
+}
+
+// Elemento com conteúdo redundante: uma cópia rasgada (publicada antes de
+// escrita) não confere
+typedef struct {
+    uint32_t seq;
+    uint32_t inv;
+    uint64_t sq;
+} item_t;
+
+#define THREAD_ITEMS 5000000u
+
+static spsc_ring_t ring_mt;
+static item_t buf_mt[256];
+
+static void *producer(void *arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < THREAD_ITEMS; ) {
+        item_t *slot = spsc_ring_claim(&ring_mt);
+        if (!slot) {                // cheio: cede a CPU ao consumidor
+            sched_yield();
+            continue;
+        }
+        slot->seq = i;
+        slot->inv = ~i;
+        slot->sq = (uint64_t)i * i;
+        spsc_ring_publish(&ring_mt);
+        i++;
+    }
+    return NULL;
+}
+
+static void test_threads(void) {
+    spsc_ring_init(&ring_mt, buf_mt, sizeof(item_t), 256);
+
+    pthread_t t;
+    uint64_t t0 = test_now_ns();
+    pthread_create(&t, NULL, producer, NULL);
+
+    uint32_t expected = 0, bad = 0;
+    while (expected < THREAD_ITEMS) {
+        const item_t *it = spsc_ring_peek(&ring_mt);
+        if (!it) {
+            sched_yield();
+            continue;
+        }
+        if (it->seq != expected || it->inv != ~expected || it->sq != (uint64_t)expected * expected) {
+            if (bad++ < 5) fprintf(stderr, "item %u: seq %u\n", expected, it->seq);
+        }
+        spsc_ring_release(&ring_mt);
+        expected++;
+    }
+    pthread_join(t, NULL);
+    uint64_t t1 = test_now_ns();
+
+    CHECK(bad == 0);
+    CHECK(ring_mt.overruns == 0);
+    CHECK(spsc_ring_count(&ring_mt) == 0);
+    printf("2 threads: %u itens de %zu bytes, %.1f M itens/s\n",
+           THREAD_ITEMS, sizeof(item_t), THREAD_ITEMS * 1e3 / (double)(t1 - t0));
+}
+
+// Mesma thread, em lotes como no loop (a IRQ enche, o loop esvazia tudo)
+static void bench_single(void) {
+    static item_t buf[64];
+    spsc_ring_t r;
+    spsc_ring_init(&r, buf, sizeof(item_t), 64);
+
+    const uint32_t rounds = 1000000;
+    item_t in = { 0 }, out;
+    uint32_t sum = 0;
+    uint64_t t0 = test_now_ns();
+    for (uint32_t k = 0; k < rounds; k++) {
+        for (int i = 0; i < 32; i++) {
+            in.seq++;
+            spsc_ring_push(&r, &in);
+        }
+        while (spsc_ring_pop(&r, &out)) sum += out.seq;
+    }
+    uint64_t t1 = test_now_ns();
+    CHECK(sum == (uint32_t)((uint64_t)rounds * 32 * (rounds * 32 + 1) / 2));
+    printf("1 thread: push+pop %.1f ns por item\n", (double)(t1 - t0) / (rounds * 32.0));
+}
+
+int main(void) {
+    test_init();
+    test_empty_full();
+    test_wraparound();
+    test_threads();
+    bench_single();
+    return test_result();
+}
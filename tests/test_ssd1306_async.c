@@ -0,0 +1,140 @@
+// ssd1306_show_async sobre o transporte assíncrono do emulador: cada transação
+// só é lida na conclusão, como pelo DMA. O front continua sendo desenhado com o
+// envio em andamento; ao final o painel deve ter exatamente o quadro congelado
+// no show_async e nenhuma transação pode ter mudado de conteúdo enquanto
+// pendente. Também confere o reenvio completo depois de um erro, nos caminhos
+// assíncrono e bloqueante.
+
+#include <string.h>
+#include "ssd1306_emu.h"
+#include "test_util.h"
+
+static ssd1306_emu_t emu;
+static ssd1306_t dev;
+static uint8_t frozen[SSD1306_BUF_SIZE];
+
+static void scribble(uint32_t *seed, int n) {
+    for (int k = 0; k < n; k++) {
+        uint32_t r = test_rand(seed);
+        uint8_t x = test_rand(seed) % SSD1306_WIDTH;
+        uint8_t y = test_rand(seed) % SSD1306_HEIGHT;
+        switch (r % 8) {
+        case 0:
+            ssd1306_clear(&dev);
+            break;
+        case 1:
+        case 2:
+            ssd1306_draw_vline(&dev, x, y, test_rand(seed) % SSD1306_HEIGHT, r & 0x100);
+            break;
+        default: {
+            char text[8];
+            int len = 1 + test_rand(seed) % 7;
+            for (int i = 0; i < len; i++) text[i] = (char)(32 + test_rand(seed) % 95);
+            text[len] = '\0';
+            ssd1306_draw_string(&dev, x, y, text);
+            break;
+        }
+        }
+    }
+}
+
+static bool panel_matches(const uint8_t *pixels) {
+    for (int p = 0; p < SSD1306_PAGES; p++) {
+        if (memcmp(emu.ram[p] + SSD1306_COL_OFFSET, &pixels[p * SSD1306_WIDTH], SSD1306_WIDTH)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void on_done(void *arg) {
+    (*(int *)arg)++;
+}
+
+// Conclui as transações uma a uma, desenhando no front entre elas
+static int drain(uint32_t *seed) {
+    int steps = 0;
+    while (ssd1306_flush_busy(&dev)) {
+        CHECK(!ssd1306_show_async(&dev, on_done, NULL));   // ocupado: não inicia outro
+        scribble(seed, 1);
+        CHECK(ssd1306_emu_complete(&emu));
+        steps++;
+    }
+    CHECK(!emu.async.pending);
+    return steps;
+}
+
+static void test_overlap(void) {
+    uint32_t seed = 2024;
+    int mismatches = 0, transactions = 0;
+
+    for (int n = 0; n < 3000; n++) {
+        scribble(&seed, 1 + test_rand(&seed) % 4);
+        memcpy(frozen, dev.buffer, SSD1306_BUF_SIZE);
+
+        int done = 0;
+        CHECK(ssd1306_show_async(&dev, on_done, &done));
+        transactions += drain(&seed);
+        CHECK(done == 1);
+
+        if (!panel_matches(frozen) && mismatches++ < 5) fprintf(stderr, "quadro %d difere do congelado\n", n);
+    }
+    CHECK(mismatches == 0);
+    CHECK(emu.async_modified == 0);
+    CHECK(dev.stats.errors == 0);
+    CHECK(transactions > 3000);     // os envios passaram mesmo pelo caminho assíncrono
+    printf("3000 quadros, %d transações assíncronas, desenho concorrente sem efeito no envio\n", transactions);
+}
+
+static void test_async_error(void) {
+    uint32_t seed = 77;
+    ssd1306_show(&dev);
+    scribble(&seed, 6);
+
+    int done = 0;
+    uint32_t errors = dev.stats.errors;
+    CHECK(ssd1306_show_async(&dev, on_done, &done));
+    CHECK(ssd1306_emu_complete(&emu));  // comandos de janela chegam
+    emu.addr = 0;                       // NACK na transação de dados
+    while (ssd1306_flush_busy(&dev)) CHECK(ssd1306_emu_complete(&emu));
+    emu.addr = SSD1306_I2C_ADDR;
+
+    CHECK(done == 1);
+    CHECK(dev.stats.errors == errors + 1);
+    CHECK(ssd1306_pending(&dev));
+
+    ssd1306_emu_reset_counters(&emu);
+    CHECK(ssd1306_show_async(&dev, on_done, &done));
+    drain(&seed);
+    CHECK(emu.data_bytes == SSD1306_BUF_SIZE);  // quadro inteiro reenviado
+    memcpy(frozen, dev.back + 1, SSD1306_BUF_SIZE);
+    CHECK(panel_matches(frozen));
+}
+
+static void test_blocking_error(void) {
+    uint32_t seed = 5;
+    ssd1306_show(&dev);
+    scribble(&seed, 6);
+
+    emu.addr = 0;
+    ssd1306_show(&dev);
+    emu.addr = SSD1306_I2C_ADDR;
+    CHECK(ssd1306_pending(&dev));
+
+    ssd1306_emu_reset_counters(&emu);
+    ssd1306_show(&dev);
+    CHECK(emu.data_bytes == SSD1306_BUF_SIZE);
+    CHECK(panel_matches(dev.buffer));
+    CHECK(!ssd1306_pending(&dev));
+}
+
+int main(void) {
+    ssd1306_emu_init(&emu, SSD1306_I2C_ADDR);
+    ssd1306_transport_t t = ssd1306_emu_transport_async(&emu);
+    ssd1306_init_transport(&dev, &t, SSD1306_I2C_ADDR);
+
+    test_overlap();
+    test_async_error();
+    test_blocking_error();
+    return test_result();
+}
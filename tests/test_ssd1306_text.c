@@ -0,0 +1,103 @@
+// ssd1306_draw_string: o blitter por colunas deve produzir o mesmo buffer que o
+// caminho antigo pixel a pixel, e marcar sujas todas as colunas que mudou.
+// Também mede os dois caminhos (y alinhado e desalinhado à página).
+
+#include <string.h>
+#include "ssd1306_emu.h"
+#include "font6x8.h"
+#include "test_util.h"
+
+// Caminho antigo: cada coluna do glifo escrita com ssd1306_draw_pixel
+static void ref_draw_string(ssd1306_t *dev, uint8_t x, uint8_t y, const char *text) {
+    while (*text) {
+        char c = *text++;
+        if (c < 32 || c > 126) c = '?';
+        for (uint8_t i = 0; i < 5; i++) {
+            uint8_t line = font6x8[(c - 32) * 5 + i];
+            for (uint8_t j = 0; j < 8; j++) {
+                bool pixel = line & (1 << j);
+                ssd1306_draw_pixel(dev, x + i, y + j, pixel);
+            }
+        }
+        x += 6;
+    }
+}
+
+static ssd1306_emu_t emu_a, emu_b;
+static ssd1306_t dev_a, dev_b;
+
+static void random_fill(uint32_t *seed) {
+    for (int i = 0; i < SSD1306_BUF_SIZE; i++) dev_a.buffer[i] = (uint8_t)test_rand(seed);
+    ssd1306_show_window(&dev_a, 0, SSD1306_WIDTH - 1, 0, SSD1306_PAGES - 1);
+    memcpy(dev_b.buffer, dev_a.buffer, SSD1306_BUF_SIZE);
+}
+
+static bool emu_matches_buffer(const ssd1306_emu_t *emu, const ssd1306_t *dev) {
+    for (int p = 0; p < SSD1306_PAGES; p++) {
+        if (memcmp(emu->ram[p] + SSD1306_COL_OFFSET, &dev->buffer[p * SSD1306_WIDTH], SSD1306_WIDTH)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_equivalence(void) {
+    uint32_t seed = 12345;
+    int mismatches = 0, stale = 0;
+
+    for (int n = 0; n < 5000; n++) {
+        random_fill(&seed);
+
+        // Até 21 caracteres a partir de x < 128: x + 6*len não passa de 255 no
+        // caminho antigo (uint8_t); inclui fora da tabela e posições de recorte
+        char text[22];
+        int len = 1 + test_rand(&seed) % 21;
+        for (int i = 0; i < len; i++) text[i] = (char)(1 + test_rand(&seed) % 140);
+        text[len] = '\0';
+        uint8_t x = test_rand(&seed) % SSD1306_WIDTH;
+        uint8_t y = test_rand(&seed) % (SSD1306_HEIGHT + 4);
+
+        ssd1306_draw_string(&dev_a, x, y, text);
+        ref_draw_string(&dev_b, x, y, text);
+        if (memcmp(dev_a.buffer, dev_b.buffer, SSD1306_BUF_SIZE)) {
+            if (mismatches++ < 5) fprintf(stderr, "buffer diferente: x=%u y=%u len=%d\n", x, y, len);
+        }
+
+        // As faixas sujas cobrem tudo o que mudou: o painel fica igual ao buffer
+        ssd1306_show(&dev_a);
+        if (!emu_matches_buffer(&emu_a, &dev_a)) {
+            if (stale++ < 5) fprintf(stderr, "faixa suja incompleta: x=%u y=%u len=%d\n", x, y, len);
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(stale == 0);
+}
+
+static double bench(void (*draw)(ssd1306_t *, uint8_t, uint8_t, const char *), ssd1306_t *dev, uint8_t y) {
+    const int iterations = 200000;
+    static const char *texts[] = { "Temp: 23.4 C", "Umid: 61.0 %" };
+
+    ssd1306_clear(dev);
+    uint64_t t0 = test_now_ns();
+    for (int i = 0; i < iterations; i++) draw(dev, 4, y, texts[i & 1]);
+    uint64_t t1 = test_now_ns();
+    return (double)(t1 - t0) / iterations;
+}
+
+int main(void) {
+    ssd1306_emu_init(&emu_a, SSD1306_I2C_ADDR);
+    ssd1306_emu_init(&emu_b, SSD1306_I2C_ADDR);
+    ssd1306_init_emu(&dev_a, &emu_a, SSD1306_I2C_ADDR);
+    ssd1306_init_emu(&dev_b, &emu_b, SSD1306_I2C_ADDR);
+
+    test_equivalence();
+
+    for (uint8_t y = 16; y <= 19; y += 3) {
+        double t_ref = bench(ref_draw_string, &dev_b, y);
+        double t_new = bench(ssd1306_draw_string, &dev_a, y);
+        printf("draw_string 12 car., y=%u: pixel a pixel %.0f ns, colunas %.0f ns (%.1fx)\n",
+               y, t_ref, t_new, t_ref / t_new);
+    }
+
+    return test_result();
+}
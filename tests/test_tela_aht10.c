@@ -0,0 +1,90 @@
+// Telas do AHT10_temp_umidade desenhadas sobre o emulador e comparadas com as
+// imagens de referência. Passa pelas três telas no mesmo display, como no
+// firmware: só a troca de tela limpa, o resto é atualização parcial. No
+// alerta, o pisca do "ATENCAO" deve reenviar só a linha dele.
+
+#include "tela.h"
+#include "golden.h"
+
+static ssd1306_emu_t emu;
+static ssd1306_t oled;
+static uint32_t agora_ms = 1000;
+
+static void mostrar(float temp, float hum, tela_t *tela) {
+    tela_t nova = tela_escolher(temp, hum);
+    if (nova != *tela) {
+        *tela = nova;
+        tela_montar(&oled, nova);
+    }
+    tela_atualizar(&oled, nova, temp, hum, agora_ms);
+    ssd1306_show(&oled);
+}
+
+// Meio período do pisca: apaga (ou acende) só o retângulo do "ATENCAO"
+static void piscar(void) {
+    agora_ms += 500;
+    ssd1306_emu_reset_counters(&emu);
+    tela_piscar(&oled, agora_ms);
+    ssd1306_show(&oled);
+}
+
+static void test_pisca(void) {
+    uint8_t aceso[8][128];
+    memcpy(aceso, emu.ram, sizeof(aceso));
+
+    piscar();
+    // y = 50 ocupa as páginas 6 e 7: no máximo 2 x 42 colunas
+    CHECKF(emu.data_bytes > 0 && emu.data_bytes <= 2 * 7 * 6, "pisca enviou %u bytes", emu.data_bytes);
+    bool so_linha = true, apagou = true;
+    for (int p = 0; p < 8; p++) {
+        for (int x = 0; x < 128; x++) {
+            bool na_linha = p >= 6 && x >= 40 && x < 40 + 7 * 6;
+            if (!na_linha && emu.ram[p][x] != aceso[p][x]) so_linha = false;
+        }
+    }
+    for (int y = 50; y < 58; y++) {
+        for (int x = 40; x < 82; x++) {
+            if (ssd1306_emu_pixel(&emu, x, y)) apagou = false;
+        }
+    }
+    CHECK(so_linha);
+    CHECK(apagou);
+
+    // Antes do meio período nada muda; depois volta ao quadro aceso
+    agora_ms += 100;
+    ssd1306_emu_reset_counters(&emu);
+    tela_piscar(&oled, agora_ms);
+    ssd1306_show(&oled);
+    CHECK(emu.data_bytes == 0);
+    agora_ms -= 100;
+    piscar();
+    CHECK(memcmp(aceso, emu.ram, sizeof(aceso)) == 0);
+}
+
+int main(void) {
+    ssd1306_emu_init(&emu, SSD1306_I2C_ADDR);
+    ssd1306_init_emu(&oled, &emu, SSD1306_I2C_ADDR);
+
+    // Antes da primeira leitura: "--", que os números depois cobrem por inteiro
+    tela_t tela = TELA_NORMAL;
+    tela_montar(&oled, tela);
+    tela_sem_leitura(&oled);
+    ssd1306_show(&oled);
+    golden_check(&emu, "aht10_sem_leitura");
+
+    mostrar(21.00f, 50.00f, &tela);
+    mostrar(23.45f, 55.10f, &tela);
+    CHECK(tela == TELA_NORMAL);
+    golden_check(&emu, "aht10_normal");
+
+    mostrar(25.00f, 82.50f, &tela);
+    CHECK(tela == TELA_UMIDADE_ALTA);
+    golden_check(&emu, "aht10_umidade_alta");
+    test_pisca();
+
+    mostrar(15.25f, 40.00f, &tela);
+    CHECK(tela == TELA_TEMP_BAIXA);
+    golden_check(&emu, "aht10_temp_baixa");
+
+    return test_result();
+}
@@ -0,0 +1,60 @@
+// Telas do MPU6050_Servo desenhadas sobre o emulador e comparadas com as
+// imagens de referência: valores, alerta em letreiro e histórico de AX. O
+// histórico chega em lotes de tamanhos variados (as amostras de cada volta do
+// loop) e deve dar a mesma imagem que uma amostra por quadro.
+
+#include "tela.h"
+#include "golden.h"
+
+static ssd1306_emu_t emu;
+static int32_t historico[1];
+static ssd1306_t oled;
+
+// Onda triangular em mg, sem libm: a imagem não depende da plataforma
+static int32_t ax_amostra(int i) {
+    int fase = i % 40;
+    return (fase < 20 ? fase : 40 - fase) * 60 - 600;
+}
+
+int main(void) {
+    ssd1306_emu_init(&emu, SSD1306_I2C_ADDR);
+    ssd1306_init_emu(&oled, &emu, SSD1306_I2C_ADDR);
+
+    tela_montar(&oled, false);
+    historico[0] = 12;
+    tela_historico(&oled, false, historico, 1);
+    tela_atualizar(&oled, false, 12, 90.0f, 90.0f);
+    ssd1306_show(&oled);
+    historico[0] = -523;
+    tela_historico(&oled, false, historico, 1);
+    tela_atualizar(&oled, false, -523, 74.0f, 62.0f);
+    ssd1306_show(&oled);
+    golden_check(&emu, "mpu6050_valores");
+
+    // O letreiro é rolado pelo controlador: a GDDRAM guarda o texto sem deslocar,
+    // e as atualizações seguintes não podem escrever na página em rolagem
+    tela_alerta(&oled, "!!! ALERTA >90 !!!");
+    historico[0] = 480;
+    tela_historico(&oled, false, historico, 1);
+    tela_atualizar(&oled, false, 480, 118.0f, 131.0f);
+    ssd1306_show(&oled);
+    CHECK(emu.scrolling);
+    CHECK(emu.ram_writes_into_scroll == 0);
+    golden_check(&emu, "mpu6050_alerta");
+
+    // O histórico foi gravado também fora do gráfico
+    tela_alerta(&oled, NULL);
+    tela_montar(&oled, true);
+    int32_t lote[20];
+    for (int i = 0, n = 1; i < 150; i += n, n = n % 17 + 3) {
+        if (n > 150 - i) n = 150 - i;
+        for (int k = 0; k < n; k++) lote[k] = ax_amostra(i + k);
+        tela_historico(&oled, true, lote, (uint16_t)n);
+        tela_atualizar(&oled, true, lote[n - 1], 90.0f, 90.0f);
+        ssd1306_show(&oled);
+    }
+    CHECK(!emu.scrolling);
+    golden_check(&emu, "mpu6050_grafico");
+
+    return test_result();
+}
@@ -0,0 +1,50 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+// Utilitários mínimos dos testes de host: verificação sem abortar e relógio
+// para os benchmarks
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+static int test_failures;
+
+#define CHECK(cond) do {                                                        \
+    if (!(cond)) {                                                              \
+        fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond);     \
+        test_failures++;                                                        \
+    }                                                                           \
+} while (0)
+
+// Como CHECK, com uma mensagem formatada
+#define CHECKF(cond, ...) do {                                                  \
+    if (!(cond)) {                                                              \
+        fprintf(stderr, "%s:%d: falhou: %s: ", __FILE__, __LINE__, #cond);     \
+        fprintf(stderr, __VA_ARGS__);                                           \
+        fputc('\n', stderr);                                                    \
+        test_failures++;                                                        \
+    }                                                                           \
+} while (0)
+
+static inline int test_result(void) {
+    if (test_failures) fprintf(stderr, "%d falha(s)\n", test_failures);
+    return test_failures ? 1 : 0;
+}
+
+static inline uint64_t test_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Gerador pseudoaleatório determinístico (xorshift32)
+static inline uint32_t test_rand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+#endif